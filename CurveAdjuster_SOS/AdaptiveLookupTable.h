@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    AdaptiveLookupTable.h
+    Created: 17 Oct 2026 12:54:52pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "QuadraticSegment.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace CurveAdjuster
+{
+    struct AdaptiveTableReport
+    {
+        size_t numKnots {0};
+        size_t sizeInBytes {0};  //knots, slopes and index together
+        float maxError {0.0f};   //largest difference from the segments found while building
+        bool metTarget {true};   //false when maxKnots ran out first
+    };
+
+    /*piecewise linear table with knots placed where the curve needs them instead of evenly:
+     each segment is split in half (in t) until the chord stays within maxError of it, so flat
+     stretches cost two knots while steep "binary" or staircase corners get as many as they need.
+     segment ends are always knots, so corners between connectors stay sharp.
+     (where a tangent is vertical, inputs within one float step of it can differ by more:
+     every y there shares the same x)
+     lookup goes through a small index of evenly spaced buckets, each knowing which knots it
+     spans, then a binary search inside the bucket. JUCE free, see CurveKernel.h*/
+    class AdaptiveLookupTable
+    {
+    public:
+        static constexpr size_t defaultMaxKnots {1 << 16};
+
+        //allocates, so call from the message thread
+        AdaptiveTableReport Build(const QuadraticSegment* segments, size_t numSegments, float maxError, size_t maxKnots = defaultMaxKnots)
+        {
+            Clear();
+            AdaptiveTableReport report;
+            if (numSegments == 0)
+            {
+                return report;
+            }
+            maxError = std::max(maxError, 1.0e-7f);
+            maxKnots = std::max(maxKnots, numSegments + 1);
+
+            struct Interval { float startT, endT; };
+            std::vector<Interval> pending;
+            for (size_t s = 0; s < numSegments; ++s)
+            {
+                const auto& segment = segments[s];
+                AddKnot(segment.GetX_AtT(0.0f), segment.GetY_AtT(0.0f));
+
+                pending.push_back({0.0f, 1.0f});
+                while (! pending.empty())
+                {
+                    const auto interval = pending.back();
+                    pending.pop_back();
+
+                    const auto error = GetChordError(segment, interval.startT, interval.endT);
+                    //the knots still owed for the rest of the curve are kept back from maxKnots, clamped so it can't wrap
+                    const auto knotsOwed = knotX.size() + (numSegments - 1 - s) + pending.size();
+                    const auto knotsLeft = maxKnots > knotsOwed ? maxKnots - knotsOwed : 0;
+                    const auto midT = 0.5f * (interval.startT + interval.endT);
+                    const auto canSplit = knotsLeft > 1 && midT > interval.startT && midT < interval.endT;
+                    if (error > maxError && canSplit)
+                    {
+                        //left half on top, so knots come out in increasing x
+                        pending.push_back({midT, interval.endT});
+                        pending.push_back({interval.startT, midT});
+                        continue;
+                    }
+                    if (error > maxError)
+                    {
+                        report.metTarget = false;
+                    }
+                    report.maxError = std::max(report.maxError, error);
+                    AddKnot(segment.GetX_AtT(interval.endT), segment.GetY_AtT(interval.endT));
+                }
+            }
+
+            BuildSlopesAndIndex();
+            report.numKnots = knotX.size();
+            report.sizeInBytes = GetSizeInBytes();
+            return report;
+        }
+
+        void Clear()
+        {
+            knotX.clear();
+            knotY.clear();
+            slopes.clear();
+            bucketStarts.clear();
+        }
+
+        float GetValue(float in_X) const
+        {
+            const auto x = std::clamp(in_X, 0.0f, 1.0f);
+            const auto bucket = std::min(static_cast<size_t>(x * bucketScale), bucketStarts.size() - 2);
+            //the last knot at or before x lies between this bucket's first and the next bucket's first
+            const auto* first = knotX.data() + bucketStarts[bucket];
+            const auto* last = knotX.data() + bucketStarts[bucket + 1];
+            const auto knot = static_cast<size_t>(std::upper_bound(first + 1, last + 1, x) - knotX.data()) - 1;
+            const auto interval = std::min(knot, knotX.size() - 2);
+            return knotY[interval] + (x - knotX[interval]) * slopes[interval];
+        }
+
+        void Process(const float* in, float* out, int numSamples) const
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                out[i] = GetValue(in[i]);
+            }
+        }
+
+        size_t GetNumKnots() const
+        {
+            return knotX.size();
+        }
+
+        size_t GetSizeInBytes() const
+        {
+            return (knotX.size() + knotY.size() + slopes.size()) * sizeof(float) + bucketStarts.size() * sizeof(uint32_t);
+        }
+
+        bool IsEmpty() const
+        {
+            return knotX.empty();
+        }
+
+    private:
+        static constexpr int numErrorProbes {8};
+
+        //largest distance between the segment and the straight line joining its points at startT and endT
+        static float GetChordError(const QuadraticSegment& segment, float startT, float endT)
+        {
+            const auto startX = segment.GetX_AtT(startT);
+            const auto startY = segment.GetY_AtT(startT);
+            const auto width = segment.GetX_AtT(endT) - startX;
+            const auto rise = segment.GetY_AtT(endT) - startY;
+            auto error = 0.0f;
+            for (int i = 1; i < numErrorProbes; ++i)
+            {
+                const auto t = startT + (endT - startT) * static_cast<float>(i) / static_cast<float>(numErrorProbes);
+                const auto x = segment.GetX_AtT(t);
+                //a vertical chord can't be interpolated, the lookup jumps at its x
+                const auto chordY = width > 0.0f ? startY + (x - startX) / width * rise : startY;
+                error = std::max(error, std::abs(segment.GetY_AtT(t) - chordY));
+            }
+            return error;
+        }
+
+        void AddKnot(float x, float y)
+        {
+            if (! knotX.empty() && x == knotX.back() && y == knotY.back())
+            {
+                return;
+            }
+            knotX.push_back(x);
+            knotY.push_back(y);
+        }
+
+        void BuildSlopesAndIndex()
+        {
+            if (knotX.size() == 1)
+            {
+                AddKnot(1.0f, knotY.back()); //a flat curve still needs an interval
+                if (knotX.size() == 1)
+                {
+                    knotX.push_back(1.0f);
+                    knotY.push_back(knotY.back());
+                }
+            }
+
+            slopes.resize(knotX.size());
+            for (size_t i = 0; i + 1 < knotX.size(); ++i)
+            {
+                const auto width = knotX[i + 1] - knotX[i];
+                slopes[i] = width > 0.0f ? (knotY[i + 1] - knotY[i]) / width : 0.0f;
+            }
+            slopes.back() = 0.0f;
+
+            //about one bucket per knot, a power of two
+            size_t numBuckets = 16;
+            while (numBuckets < knotX.size() && numBuckets < (1 << 16))
+            {
+                numBuckets *= 2;
+            }
+            bucketScale = static_cast<float>(numBuckets);
+            bucketStarts.resize(numBuckets + 1);
+            for (size_t b = 0; b <= numBuckets; ++b)
+            {
+                const auto bucketStartX = static_cast<float>(b) / bucketScale;
+                const auto knot = std::upper_bound(knotX.begin(), knotX.end(), bucketStartX) - knotX.begin();
+                bucketStarts[b] = static_cast<uint32_t>(std::max<std::ptrdiff_t>(knot - 1, 0));
+            }
+            bucketStarts.back() = static_cast<uint32_t>(knotX.size() - 1);
+        }
+
+        std::vector<float> knotX;
+        std::vector<float> knotY;
+        std::vector<float> slopes;           //per knot, towards the next one
+        std::vector<uint32_t> bucketStarts;  //numBuckets + 1, the last knot at or before each bucket's start
+        float bucketScale {1.0f};
+    };
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    BakedCurve.h
+    Created: 17 Oct 2026 12:46:51pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "SegmentBuilder.h"
+#include <array>
+#include <cstddef>
+
+namespace CurveAdjuster
+{
+    template <size_t numConnectors>
+    using CurveDefinition = std::array<ConnectorDefinition, numConnectors>;
+
+    namespace BakedMath
+    {
+        //newton's method in double, so the float result matches std::sqrt for the values curves produce
+        constexpr float Sqrt(float v)
+        {
+            if (! (v > 0.0f))
+            {
+                return 0.0f;
+            }
+            const auto target = static_cast<double>(v);
+            auto estimate = target > 1.0 ? target : 1.0; //starting above the root, newton only comes down
+            for (int i = 0; i < 64; ++i)
+            {
+                const auto next = 0.5 * (estimate + target / estimate);
+                if (! (next < estimate))
+                {
+                    break;
+                }
+                estimate = next;
+            }
+            return static_cast<float>(estimate);
+        }
+    }
+
+    /*a curve whose segment coefficients and lookup table are computed by the compiler:
+        inline constexpr CurveAdjuster::BakedCurve<3> myCurve {myCurveDefinition};
+     GetValue is a constexpr table interpolation the compiler can inline (or fold, for constant input).
+     pass it to the CurveAdjusterProcessor constructor to start with the table instead of building one.
+     connectors must be in order and the last has to end at x = 1, the same as for SetConnectors*/
+    template <size_t numConnectors, size_t numPoints = 1024>
+    class BakedCurve
+    {
+    public:
+        static_assert(numConnectors >= 1, "a curve needs at least one connector");
+        static_assert(numPoints >= 2, "a table needs both end points");
+
+        constexpr explicit BakedCurve(const CurveDefinition<numConnectors>& _definition)
+        : definition(_definition)
+        {
+            SegmentBuilder::BuildSegments([this](size_t i) { return definition[i]; }, numConnectors, segments.data());
+            for (size_t i = 0; i < numPoints; ++i)
+            {
+                table[i] = Solve(static_cast<float>(i) / static_cast<float>(numPoints - 1));
+            }
+        }
+
+        //same interpolation as CurveLookupTable::GetValue
+        constexpr float GetValue(float in_X) const
+        {
+            const float position = std::clamp(in_X, 0.0f, 1.0f) * static_cast<float>(numPoints - 1);
+            const auto index = std::min(static_cast<size_t>(position), numPoints - 2);
+            const float fraction = position - static_cast<float>(index);
+            return table[index] + fraction * (table[index + 1] - table[index]);
+        }
+
+        constexpr const CurveDefinition<numConnectors>& GetDefinition() const
+        {
+            return definition;
+        }
+
+        constexpr const std::array<QuadraticSegment, numConnectors>& GetSegments() const
+        {
+            return segments;
+        }
+
+        constexpr const std::array<float, numPoints>& GetTable() const
+        {
+            return table;
+        }
+
+    private:
+        //same segment choice as SegmentCursor: the last segment starting at or before in_X
+        constexpr float Solve(float in_X) const
+        {
+            size_t index = 0;
+            for (size_t i = 1; i < numConnectors; ++i)
+            {
+                if (segments[i].startX <= in_X)
+                {
+                    index = i;
+                }
+            }
+            const auto& segment = segments[index];
+            return segment.GetY_AtT(segment.GetT_AtX(in_X, BakedMath::Sqrt));
+        }
+
+        CurveDefinition<numConnectors> definition;
+        std::array<QuadraticSegment, numConnectors> segments {};
+        std::array<float, numPoints> table {};
+    };
+}
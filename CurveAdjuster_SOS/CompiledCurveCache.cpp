@@ -0,0 +1,344 @@
+/*
+  ==============================================================================
+
+    CompiledCurveCache.cpp
+    Created: 17 Oct 2026 1:10:13pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CompiledCurveCache.h"
+
+namespace CurveAdjuster
+{
+
+static_assert(sizeof(ConnectorDefinition) == 7 * sizeof(float), "connectors are hashed, compared and stored as raw bytes");
+
+//64 bit FNV-1a
+static constexpr uint64_t hashOffsetBasis {14695981039346656037ull};
+static constexpr uint64_t hashPrime {1099511628211ull};
+
+//==============================================================================
+CompiledCurveCache::Reference::Reference(Entry* _entry)
+: entry(_entry)
+{
+    if (entry != nullptr)
+    {
+        entry->referenceCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+CompiledCurveCache::Reference::Reference(Reference&& other) noexcept
+: entry(std::exchange(other.entry, nullptr))
+{
+}
+
+CompiledCurveCache::Reference& CompiledCurveCache::Reference::operator= (Reference&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        entry = std::exchange(other.entry, nullptr);
+    }
+    return *this;
+}
+
+CompiledCurveCache::Reference::~Reference()
+{
+    Release();
+}
+
+const CurveSnapshot* CompiledCurveCache::Reference::Get() const
+{
+    return entry != nullptr ? &entry->compiled : nullptr;
+}
+
+AdaptiveTableReport CompiledCurveCache::Reference::GetAdaptiveTableReport() const
+{
+    return entry != nullptr ? entry->report : AdaptiveTableReport();
+}
+
+void CompiledCurveCache::Reference::Release()
+{
+    //never frees, see CollectGarbage
+    if (entry != nullptr)
+    {
+        entry->referenceCount.fetch_sub(1, std::memory_order_release);
+        entry = nullptr;
+    }
+}
+
+//==============================================================================
+CompiledCurveCache::Entry::Entry(size_t numSegments)
+: compiled(numSegments)
+{
+}
+
+CompiledCurveCache::~CompiledCurveCache()
+{
+    //references must not outlive the cache
+    jassert(std::all_of(entries.begin(), entries.end(), [](const auto& e) { return e->referenceCount.load() == 0; }));
+}
+
+CompiledCurveCache::Reference CompiledCurveCache::Intern(const std::vector<ConnectorPoints>& points, size_t tableSize, LookupTableFormat tableFormat,
+                                                         float tableMaxError, const Reference& previous, const DirtyRange& dirty)
+{
+    std::vector<ConnectorDefinition> connectors;
+    connectors.reserve(points.size());
+    for (const auto& c : points)
+    {
+        connectors.push_back(c.ToDefinition());
+    }
+    const auto hash = Hash(connectors, tableSize, tableFormat, tableMaxError);
+    auto findExisting = [&]() -> Entry*
+    {
+        for (const auto& e : entries)
+        {
+            const auto isSame = e->hash == hash && e->tableSize == tableSize && e->tableFormat == tableFormat
+                             && e->tableMaxError == tableMaxError && e->connectors.size() == connectors.size()
+                             && std::memcmp(e->connectors.data(), connectors.data(), connectors.size() * sizeof(ConnectorDefinition)) == 0;
+            if (isSame)
+            {
+                return e.get();
+            }
+        }
+        return nullptr;
+    };
+    
+    juce::File directory;
+    {
+        const juce::ScopedLock sl(lock);
+        if (auto* existing = findExisting())
+        {
+            return Reference(existing);
+        }
+        directory = diskDirectory;
+    }
+    
+    auto entry = std::make_unique<Entry>(connectors.size());
+    entry->hash = hash;
+    entry->tableSize = tableSize;
+    entry->tableFormat = tableFormat;
+    entry->tableMaxError = tableMaxError;
+    entry->connectors = connectors;
+    //the file is read without the lock so other instances aren't held up by the disk
+    entry->isOnDisk = tableSize != 0 && LoadFromDisk(*entry, directory);
+    
+    //compiling under the lock means two instances asking for a new curve at once compile it once
+    const juce::ScopedLock sl(lock);
+    if (auto* existing = findExisting())
+    {
+        return Reference(existing); //made by another instance while the file was read
+    }
+    CollectGarbageLocked();
+    
+    auto& compiled = entry->compiled;
+    auto getConnector = [&entry](size_t i) { return entry->connectors[i]; };
+    SegmentBuilder::BuildSegments(getConnector, entry->connectors.size(), compiled.segments.data());
+    compiled.numSegments = entry->connectors.size();
+    compiled.UpdateSegmentSummaries();
+    
+    //the caller's previous table only differs in the dirty inputs
+    const auto* previousCompiled = previous.Get();
+    if (entry->isOnDisk)
+    {
+        //the table came from the file
+    }
+    else if (previousCompiled != nullptr && previous.entry->tableSize == tableSize && previous.entry->tableFormat == tableFormat)
+    {
+        compiled.lookupTable = previousCompiled->lookupTable;
+        compiled.fixedPointTable = previousCompiled->fixedPointTable;
+        compiled.UpdateLookupTable(tableSize, tableFormat, dirty);
+    }
+    else
+    {
+        compiled.UpdateLookupTable(tableSize, tableFormat);
+    }
+    entry->report = compiled.UpdateAdaptiveTable(tableMaxError);
+    
+    entries.push_back(std::move(entry));
+    return Reference(entries.back().get());
+}
+
+void CompiledCurveCache::CollectGarbage()
+{
+    const juce::ScopedLock sl(lock);
+    CollectGarbageLocked();
+}
+
+void CompiledCurveCache::CollectGarbageLocked()
+{
+    //an entry at 0 can't be picked up again except through Intern, which holds the lock
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [](const auto& e)
+    {
+        return e->referenceCount.load(std::memory_order_acquire) == 0;
+    }), entries.end());
+}
+
+size_t CompiledCurveCache::GetNumEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return entries.size();
+}
+
+void CompiledCurveCache::SetDiskCacheDirectory(const juce::File& directory)
+{
+    const juce::ScopedLock sl(lock);
+    if (directory == diskDirectory)
+    {
+        return;
+    }
+    diskDirectory = directory;
+    for (auto& e : entries)
+    {
+        e->isOnDisk = false;
+    }
+}
+
+bool CompiledCurveCache::SaveToDisk()
+{
+    const juce::ScopedLock sl(lock);
+    if (diskDirectory == juce::File() || ! diskDirectory.createDirectory().wasOk())
+    {
+        return false;
+    }
+    auto allSaved = true;
+    for (auto& e : entries)
+    {
+        if (e->tableSize == 0 || e->isOnDisk || e->referenceCount.load(std::memory_order_acquire) == 0)
+        {
+            continue;
+        }
+        e->isOnDisk = SaveToDisk(*e);
+        allSaved = allSaved && e->isOnDisk;
+    }
+    return allSaved;
+}
+
+juce::File CompiledCurveCache::GetDiskFile(const juce::File& directory, const Entry& entry)
+{
+    return directory.getChildFile(juce::String::toHexString(static_cast<juce::int64>(entry.hash)).paddedLeft('0', 16) + ".curvetable");
+}
+
+bool CompiledCurveCache::LoadFromDisk(Entry& entry, const juce::File& directory)
+{
+    if (directory == juce::File())
+    {
+        return false;
+    }
+    const auto file = GetDiskFile(directory, entry);
+    juce::MemoryBlock contents;
+    if (! file.existsAsFile() || ! file.loadFileAsData(contents) || contents.getSize() < sizeof(DiskHeader))
+    {
+        return false;
+    }
+    const auto* bytes = static_cast<const uint8_t*>(contents.getData());
+    
+    DiskHeader header;
+    std::memcpy(&header, bytes, sizeof(header));
+    const auto isFloat = entry.tableFormat == LookupTableFormat::floatingPoint;
+    const auto bytesPerPoint = isFloat ? sizeof(float) : sizeof(uint16_t);
+    const auto connectorBytes = entry.connectors.size() * sizeof(ConnectorDefinition);
+    const auto tableBytes = entry.tableSize * bytesPerPoint;
+    const auto isThisCurve = header.magic == diskMagic && header.version == diskVersion && header.hash == entry.hash
+                          && header.numConnectors == entry.connectors.size() && header.tableSize == entry.tableSize
+                          && header.tableFormat == static_cast<int32_t>(entry.tableFormat) && header.bytesPerPoint == bytesPerPoint
+                          && contents.getSize() == sizeof(header) + connectorBytes + tableBytes;
+    if (! isThisCurve)
+    {
+        return false;
+    }
+    //a curve with the same hash, or a damaged file. either way it's compiled instead and SaveToDisk replaces the file
+    const auto* connectorData = bytes + sizeof(header);
+    const auto* tableData = connectorData + connectorBytes;
+    auto checksum = hashOffsetBasis;
+    AddToHash(checksum, connectorData, connectorBytes + tableBytes);
+    if (checksum != header.checksum || std::memcmp(connectorData, entry.connectors.data(), connectorBytes) != 0)
+    {
+        return false;
+    }
+    
+    //the header and connectors are multiples of 4 bytes, so the table is aligned in the block
+    auto& compiled = entry.compiled;
+    if (isFloat)
+    {
+        compiled.lookupTable.Assign(reinterpret_cast<const float*>(tableData), entry.tableSize);
+        compiled.fixedPointTable.Clear();
+    }
+    else
+    {
+        compiled.fixedPointTable.Assign(reinterpret_cast<const uint16_t*>(tableData), entry.tableSize);
+        compiled.lookupTable.Clear();
+    }
+    return true;
+}
+
+bool CompiledCurveCache::SaveToDisk(const Entry& entry) const
+{
+    const auto isFloat = entry.tableFormat == LookupTableFormat::floatingPoint;
+    const auto* tableData = isFloat ? static_cast<const void*>(entry.compiled.lookupTable.GetData())
+                                    : static_cast<const void*>(entry.compiled.fixedPointTable.GetData());
+    const auto numPoints = isFloat ? entry.compiled.lookupTable.GetNumPoints() : entry.compiled.fixedPointTable.GetNumPoints();
+    if (numPoints != entry.tableSize)
+    {
+        jassertfalse; //the entry was compiled with a table
+        return false;
+    }
+    
+    DiskHeader header {};
+    header.magic = diskMagic;
+    header.version = diskVersion;
+    header.hash = entry.hash;
+    header.numConnectors = entry.connectors.size();
+    header.tableSize = entry.tableSize;
+    header.tableFormat = static_cast<int32_t>(entry.tableFormat);
+    header.bytesPerPoint = static_cast<uint32_t>(isFloat ? sizeof(float) : sizeof(uint16_t));
+    const auto connectorBytes = entry.connectors.size() * sizeof(ConnectorDefinition);
+    const auto tableBytes = entry.tableSize * header.bytesPerPoint;
+    header.checksum = hashOffsetBasis;
+    AddToHash(header.checksum, entry.connectors.data(), connectorBytes);
+    AddToHash(header.checksum, tableData, tableBytes);
+    
+    //written beside the target and moved over it, so a reader never maps a half written file
+    juce::TemporaryFile temporary(GetDiskFile(diskDirectory, entry));
+    {
+        juce::FileOutputStream out(temporary.getFile());
+        if (! out.openedOk())
+        {
+            return false;
+        }
+        const auto written = out.write(&header, sizeof(header))
+                          && out.write(entry.connectors.data(), connectorBytes)
+                          && out.write(tableData, tableBytes);
+        out.flush();
+        if (! written || out.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    return temporary.overwriteTargetFileWithTemporary();
+}
+
+void CompiledCurveCache::AddToHash(uint64_t& hash, const void* data, size_t numBytes)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        hash = (hash ^ bytes[i]) * hashPrime;
+    }
+}
+
+uint64_t CompiledCurveCache::Hash(const std::vector<ConnectorDefinition>& connectors, size_t tableSize, LookupTableFormat tableFormat, float tableMaxError)
+{
+    auto hash = hashOffsetBasis;
+    AddToHash(hash, connectors.data(), connectors.size() * sizeof(ConnectorDefinition));
+    const auto size = static_cast<uint64_t>(tableSize);
+    const auto format = static_cast<int32_t>(tableFormat);
+    AddToHash(hash, &size, sizeof(size));
+    AddToHash(hash, &format, sizeof(format));
+    AddToHash(hash, &tableMaxError, sizeof(tableMaxError));
+    return hash;
+}
+
+}
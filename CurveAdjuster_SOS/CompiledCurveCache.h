@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    CompiledCurveCache.h
+    Created: 17 Oct 2026 1:10:13pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CurveAdjusterProcessorData.h"
+#include "CurveSnapshot.h"
+#include <juce_core/juce_core.h>
+
+namespace CurveAdjuster
+{
+    /*compiled lookup tables keyed by the curve's content (connectors and table settings), shared through
+     juce::SharedResourcePointer, so every instance with the same curve (the default ramp, a preset on
+     every voice) holds one table in memory that was compiled once.
+     entries are reference counted. releasing is a single atomic decrement and never frees, so a
+     Reference can be dropped on any thread, the audio thread included. unreferenced entries are freed
+     by the next Intern or by CollectGarbage, on the writer's thread.
+     optionally backed by a directory of tables on disk, see SetDiskCacheDirectory*/
+    class CompiledCurveCache
+    {
+    private:
+        struct Entry;
+
+    public:
+        //one counted use of an entry, move only
+        class Reference
+        {
+        public:
+            Reference() = default;
+            Reference(Reference&& other) noexcept;
+            Reference& operator= (Reference&& other) noexcept;
+            ~Reference();
+
+            //a snapshot holding the tables (and the segments they were sampled from), nullptr when empty
+            const CurveSnapshot* Get() const;
+            AdaptiveTableReport GetAdaptiveTableReport() const;
+            void Release();
+
+        private:
+            friend class CompiledCurveCache;
+            explicit Reference(Entry* _entry);
+
+            Entry* entry {nullptr};
+        };
+
+        CompiledCurveCache() = default;
+        ~CompiledCurveCache();
+
+        /*the entry for this curve and these settings, compiled now if there isn't one.
+         previous (which may be empty) is what the caller held before and dirty what changed since:
+         a new entry starts from a copy of its table and only resamples the dirty inputs.
+         allocates and may compile, not for the audio thread*/
+        Reference Intern(const std::vector<ConnectorPoints>& points, size_t tableSize, LookupTableFormat tableFormat,
+                         float tableMaxError, const Reference& previous, const DirtyRange& dirty);
+
+        //frees every entry nothing references
+        void CollectGarbage();
+        size_t GetNumEntries() const;
+
+        /*opt in: a new entry first looks for its lookup table in directory (read outside the lock, and used
+         only if it's intact and was made from exactly this curve), so reopening a session reads tables instead
+         of sampling them again. adaptive tables are always built. an empty File turns this off*/
+        void SetDiskCacheDirectory(const juce::File& directory);
+        /*writes the lookup table of every live entry that isn't on disk yet, e.g. once a session has loaded.
+         tables aren't written as they're compiled so dragging a handle doesn't leave a file per step.
+         returns false if any write failed. message thread*/
+        bool SaveToDisk();
+
+    private:
+        struct Entry
+        {
+            explicit Entry(size_t numSegments);
+
+            uint64_t hash {0};
+            std::vector<ConnectorDefinition> connectors;
+            size_t tableSize {0};
+            LookupTableFormat tableFormat {LookupTableFormat::floatingPoint};
+            float tableMaxError {0.0f};
+
+            CurveSnapshot compiled;
+            AdaptiveTableReport report;
+            std::atomic<int> referenceCount {0};
+            bool isOnDisk {false}; //guarded by lock
+        };
+
+        //every field is fixed width, followed by the connectors and then the table
+        struct DiskHeader
+        {
+            uint32_t magic;   //also rejects files written with the other byte order
+            uint32_t version;
+            uint64_t hash;
+            uint64_t numConnectors;
+            uint64_t tableSize;
+            int32_t tableFormat;
+            uint32_t bytesPerPoint;
+            uint64_t checksum; //of everything after the header
+        };
+        static_assert(sizeof(DiskHeader) == 48, "the header is written as raw bytes, so it can't have padding");
+        static constexpr uint32_t diskMagic {0x534f5343}; //"SOSC"
+        static constexpr uint32_t diskVersion {1};
+
+        static void AddToHash(uint64_t& hash, const void* data, size_t numBytes);
+        static uint64_t Hash(const std::vector<ConnectorDefinition>& connectors, size_t tableSize, LookupTableFormat tableFormat, float tableMaxError);
+        void CollectGarbageLocked(); //caller holds lock
+
+        //fills a new entry's lookup table from its file in directory, false if there's no usable file. touches no members
+        static bool LoadFromDisk(Entry& entry, const juce::File& directory);
+        bool SaveToDisk(const Entry& entry) const; //caller holds lock
+        static juce::File GetDiskFile(const juce::File& directory, const Entry& entry);
+
+        juce::CriticalSection lock; //writers only, the audio thread never takes it
+        std::vector<std::unique_ptr<Entry>> entries;
+        juce::File diskDirectory; //guarded by lock
+
+        JUCE_DECLARE_NON_COPYABLE(CompiledCurveCache)
+    };
+}
@@ -11,8 +11,8 @@
 #include "Connector.h"
 
 
-Connector::Connector(pointType _start, pointType _end)
-: start(_start), end(_end)
+Connector::Connector(pointType _start, pointType _end, SegmentType _type)
+: start(_start), end(_end), type(_type)
 {
     /*this constructor doesn't have a control point so we are
     setting a default control point for a straight line
@@ -21,8 +21,8 @@ Connector::Connector(pointType _start, pointType _end)
     SetPath();
 }
 
-Connector::Connector(pointType _start, pointType _control, pointType _end)
-: start(_start), control(_control), end(_end)
+Connector::Connector(pointType _start, pointType _control, pointType _end, SegmentType _type)
+: start(_start), control(_control), end(_end), type(_type)
 {
     SetPath();
 }
@@ -32,7 +32,12 @@ Connector::Connector(const Connector& other)
     start = other.start;
     control = other.control;
     end = other.end;
+    type = other.type;
     path = other.path;
+    //copies aren't in the editor's list, so they have no neighbours
+    segment = other.segment;
+    frameWidth = other.frameWidth;
+    frameHeight = other.frameHeight;
 }
 
 void Connector::paint(juce::Graphics& g)
@@ -71,11 +76,76 @@ void Connector::AdjustEndPoint(pointType newEnd)
     repaint();
 }
 
+//rebuilds this connector and any monotoneCubic next to it, whose end slope depends on this one
 void Connector::SetPath()
 {
+    BuildPath();
+    if (previousConnector != nullptr && previousConnector->type == SegmentType::monotoneCubic)
+    {
+        previousConnector->BuildPath();
+        previousConnector->repaint();
+    }
+    if (nextConnector != nullptr && nextConnector->type == SegmentType::monotoneCubic)
+    {
+        nextConnector->BuildPath();
+        nextConnector->repaint();
+    }
+}
+
+void Connector::SetFrame(float width, float height)
+{
+    frameWidth = width;
+    frameHeight = height;
+    BuildPath();
+}
+
+void Connector::SetNeighbours(Connector* previous, Connector* next)
+{
+    previousConnector = previous;
+    nextConnector = next;
+    BuildPath();
+}
+
+ConnectorDefinition Connector::ToDefinition() const
+{
+    //same scaling as CurveAdjusterEditor::GetPointAsPercentage
+    auto toX = [this](float x) { return x / frameWidth; };
+    auto toY = [this](float y) { return 1.0f - y / frameHeight; };
+    return {toX(start.x), toY(start.y), toX(control.x), toY(control.y), toX(end.x), toY(end.y), type};
+}
+
+void Connector::BuildPath()
+{
+    //the same segment SegmentBuilder gives the processor, so what's drawn is what's heard
+    std::array<ConnectorDefinition, 3> definitions;
+    size_t numDefinitions = 0;
+    if (previousConnector != nullptr)
+    {
+        definitions[numDefinitions++] = previousConnector->ToDefinition();
+    }
+    const auto index = numDefinitions;
+    definitions[numDefinitions++] = ToDefinition();
+    if (nextConnector != nullptr)
+    {
+        definitions[numDefinitions++] = nextConnector->ToDefinition();
+    }
+    segment = SegmentBuilder::BuildSegment([&definitions](size_t i) { return definitions[i]; }, index, numDefinitions);
+    
+    //every type is at most cubic in t, so one cubic bezier draws it exactly
+    auto toPoint = [this](float x, float y) { return juce::Point<float>(x * frameWidth, (1.0f - y) * frameHeight); };
+    const auto& s = segment;
+    const auto control1 = toPoint(s.startX + s.bx / 3.0f, s.startY + s.by / 3.0f);
+    const auto control2 = toPoint(s.startX + (2.0f * s.bx + s.ax) / 3.0f, s.startY + (2.0f * s.by + s.ay) / 3.0f);
+    const auto curveEnd = toPoint(s.GetX_AtT(1.0f), s.GetY_AtT(1.0f));
+    
     path.clear();
     path.startNewSubPath(start.x, start.y);
-    path.quadraticTo(control.x, control.y, end.x, end.y);
+    path.cubicTo(control1, control2, curveEnd);
+    if (s.type == SegmentType::hold)
+    {
+        //the step up (or down) to the next connector
+        path.lineTo(end.x, end.y);
+    }
 }
 
 void Connector::ForceMouseOverFalse()
@@ -142,27 +212,5 @@ float Connector::LimitControlY_ForUpwardConnector(float inY)
 
 float Connector::GetY_AlongPath(float in_X)
 {
-    juce::PathFlatteningIterator flatPath {path};
-
-    while (flatPath.next())
-    {
-        if (juce::approximatelyEqual(in_X, flatPath.x1))
-        {
-            return flatPath.y1;
-        }
-        else if (juce::approximatelyEqual(in_X, flatPath.x2))
-        {
-            return flatPath.y2;
-        }
-        else if (in_X > flatPath.x1 && in_X < flatPath.x2)
-        {
-            juce::Line<float> pathLine {flatPath.x1, flatPath.y1, flatPath.x2, flatPath.y2};
-            juce::Line<float> verticalLineAtX {in_X, 0.0f, in_X, 1.0f};
-            return pathLine.getIntersection(verticalLineAtX).y;
-        }
-    }
-    jassertfalse; //should have found something!
-    
-    //safety lame scenario
-    return 0.0f;
+    return (1.0f - segment.GetY_AtX(in_X / frameWidth)) * frameHeight;
 }
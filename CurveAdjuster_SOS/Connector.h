@@ -11,6 +11,7 @@
 #pragma once
 #include "MouseIgnoringComponent.h"
 #include "CurveAdjusterPointTypes.h"
+#include "SegmentBuilder.h"
 
 using namespace CurveAdjuster;
 
@@ -20,8 +21,8 @@ public:
     using connectorsCollection = std::list<Connector>;
     using connectorsCollectionIterator = std::list<Connector>::iterator;
     
-    Connector(pointType _start, pointType _end);
-    Connector(pointType _start, pointType _control, pointType _end);
+    Connector(pointType _start, pointType _end, SegmentType _type = SegmentType::automatic);
+    Connector(pointType _start, pointType _control, pointType _end, SegmentType _type = SegmentType::automatic);
     Connector(const Connector&);
 
 
@@ -34,11 +35,26 @@ public:
     void SetPath();
     float GetY_AlongPath(float in_X); 
     
+    //the editor's size, which its 0-1 curve is scaled to
+    void SetFrame(float width, float height);
+    //the connectors either side, which a monotoneCubic takes its end slopes from. nullptr at either end of the curve
+    void SetNeighbours(Connector* previous, Connector* next);
+    
     pointType start, control, end;
+    SegmentType type {SegmentType::automatic}; //kept through edits, the editor only moves the points
     juce::Path path;
     bool mouseOver {false};
     
 private:
+    //the segment the processor builds for this connector, in 0-1 coordinates, and the path drawn from it
+    void BuildPath();
+    ConnectorDefinition ToDefinition() const;
+    
+    QuadraticSegment segment;
+    float frameWidth {1.0f}, frameHeight {1.0f};
+    Connector* previousConnector {nullptr};
+    Connector* nextConnector {nullptr};
+
     enum ConnectorDirection
     {
         up, down
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    CurveAdjusterBank.cpp
+    Created: 17 Oct 2026 12:49:05pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CurveAdjusterBank.h"
+
+namespace CurveAdjuster
+{
+
+//==============================================================================
+CurveAdjusterBank::Curve::Curve(CurveAdjusterBank& _bank, size_t _index, std::string n)
+: bank(_bank), index(_index), name(n)
+{
+}
+
+size_t CurveAdjusterBank::Curve::GetNumConnectors()
+{
+    return GetConnectors().size();
+}
+
+uint64_t CurveAdjusterBank::Curve::GetGeneration() const
+{
+    return bank.generations[index].load(std::memory_order_acquire);
+}
+
+void CurveAdjusterBank::Curve::SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo)
+{
+    CurveStateSerialisation::Save(stateToAppendTo, name, GetConnectors());
+}
+
+void CurveAdjusterBank::Curve::LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree)
+{
+    auto curveAdjusterTree = apvtsTree.getChildWithName(name);
+    if (curveAdjusterTree.isValid())
+    {
+        SetState(curveAdjusterTree);
+        RemoveThisCurveAdjusterTreeFromAPVTS(apvtsTree, curveAdjusterTree);
+    }
+}
+
+const juce::Identifier& CurveAdjusterBank::Curve::GetName() const
+{
+    return name;
+}
+
+void CurveAdjusterBank::Curve::SetConnectors(const std::vector<ConnectorPoints>& newConnectorPoints)
+{
+    bank.SetConnectors(index, newConnectorPoints);
+}
+
+std::vector<ConnectorPoints> CurveAdjusterBank::Curve::GetConnectors() const
+{
+    const juce::ScopedLock lock(bank.writerLock);
+    return bank.connectorPoints[index];
+}
+
+size_t CurveAdjusterBank::Curve::GetIndex() const
+{
+    return index;
+}
+
+void CurveAdjusterBank::Curve::SetState(juce::ValueTree& curveAdjusterTree)
+{
+    std::vector<ConnectorPoints> loadedPoints;
+    if (CurveStateSerialisation::Load(curveAdjusterTree, loadedPoints, maxConnectorsPerCurve))
+    {
+        SetConnectors(loadedPoints);
+    }
+}
+
+void CurveAdjusterBank::Curve::RemoveThisCurveAdjusterTreeFromAPVTS(juce::ValueTree& apvtsTree, juce::ValueTree& curveAdjusterTree)
+{
+    apvtsTree.removeChild(curveAdjusterTree, nullptr);
+}
+
+//==============================================================================
+CurveAdjusterBank::BankSnapshot::BankSnapshot(size_t numCurves, size_t _maxSegmentsPerCurve)
+: maxSegmentsPerCurve(_maxSegmentsPerCurve),
+  segments(numCurves * _maxSegmentsPerCurve),
+  numSegments(numCurves, 0)
+{
+}
+
+float CurveAdjusterBank::BankSnapshot::GetY_AtX(size_t curve, float in_X, SegmentCursor& cursor) const
+{
+    if (numSegments[curve] == 0)
+    {
+        return 0.0f;
+    }
+    const auto* curveSegments = segments.data() + curve * maxSegmentsPerCurve;
+    return curveSegments[cursor.Find(curveSegments, numSegments[curve], in_X)].GetY_AtX(in_X);
+}
+
+//==============================================================================
+CurveAdjusterBank::CurveAdjusterBank(const std::vector<std::string>& names, float initVal, double smoothingIncrement)
+: connectorPoints(names.size(), {{{0.0f, 0.0f}, {0.25f, 0.25f}, {1.0f, 1.0f}}}),
+  generations(names.size()),
+  pendingRanges(MakePendingRanges(names.size())),
+  snapshots(BankSnapshot(names.size(), maxConnectorsPerCurve)),
+  smoothers(static_cast<int>(names.size()), initVal, smoothingIncrement),
+  cursors(names.size()),
+  rampingCurves(names.size(), 0)
+{
+    curves.reserve(names.size()); //handles are never moved after this
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        curves.emplace_back(*this, i, names[i]);
+    }
+    
+    {
+        const juce::ScopedLock lock(writerLock);
+        PublishSnapshot();
+    }
+    snapshots.Update();
+}
+
+size_t CurveAdjusterBank::GetNumCurves() const
+{
+    return curves.size();
+}
+
+CurveAdjusterBank::Curve& CurveAdjusterBank::GetCurve(size_t index)
+{
+    jassert(index < curves.size());
+    return curves[index];
+}
+
+void CurveAdjusterBank::Reset(double sampleRate)
+{
+    smoothers.Reset(sampleRate);
+}
+
+void CurveAdjusterBank::ProcessBlock(const float* targets, float* const* outputs, int numSamples)
+{
+    const auto& snapshot = snapshots.Acquire();
+    const auto numCurves = smoothers.GetMaxVoices();
+    const auto* current = smoothers.GetCurrentValues();
+    
+    //curves that hold still map once, the ramping ones are gathered so the sample loop only visits them
+    auto numRamping = 0;
+    for (int c = 0; c < numCurves; ++c)
+    {
+        smoothers.SetTarget(c, targets[c]);
+        if (outputs[c] == nullptr)
+        {
+            continue;
+        }
+        if (smoothers.IsSmoothing(c))
+        {
+            rampingCurves[static_cast<size_t>(numRamping++)] = c;
+        }
+        else
+        {
+            const auto curve = static_cast<size_t>(c);
+            juce::FloatVectorOperations::fill(outputs[c], snapshot.GetY_AtX(curve, juce::jlimit(0.0f, 1.0f, current[c]), cursors[curve]), numSamples);
+        }
+    }
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        smoothers.Advance();
+        for (int r = 0; r < numRamping; ++r)
+        {
+            const auto c = static_cast<size_t>(rampingCurves[static_cast<size_t>(r)]);
+            outputs[c][sample] = snapshot.GetY_AtX(c, juce::jlimit(0.0f, 1.0f, current[c]), cursors[c]);
+        }
+    }
+}
+
+float CurveAdjusterBank::GetTranslatedOutput(size_t curve, float x)
+{
+    return snapshots.Acquire().GetY_AtX(curve, juce::jlimit(0.0f, 1.0f, x), cursors[curve]);
+}
+
+void CurveAdjusterBank::SetConnectors(size_t curve, const std::vector<ConnectorPoints>& newConnectorPoints)
+{
+    const juce::ScopedLock lock(writerLock);
+    jassert(newConnectorPoints.size() <= maxConnectorsPerCurve); //too many connectors!
+    const std::vector<ConnectorPoints> points(newConnectorPoints.begin(), newConnectorPoints.begin() + static_cast<std::ptrdiff_t>(std::min(newConnectorPoints.size(), maxConnectorsPerCurve)));
+    const auto dirty = FindDirtyRange(connectorPoints[curve], points);
+    if (dirty.IsEmpty())
+    {
+        return;
+    }
+    connectorPoints[curve] = points;
+    generations[curve].fetch_add(1, std::memory_order_release);
+    for (auto& pending : pendingRanges)
+    {
+        pending[curve].Add(dirty);
+    }
+    PublishSnapshot();
+}
+
+CurveAdjusterBank::PendingRanges CurveAdjusterBank::MakePendingRanges(size_t numCurves)
+{
+    //every buffer starts out missing every curve
+    PendingRanges ranges;
+    ranges.fill(std::vector<DirtyRange>(numCurves, DirtyRange::All()));
+    return ranges;
+}
+
+void CurveAdjusterBank::PublishSnapshot()
+{
+    //the write buffer holds an older version of the bank, only the segments edited since then are rebuilt
+    auto& snapshot = snapshots.GetWriteBuffer();
+    auto& pending = pendingRanges[snapshots.GetWriteIndex()];
+    for (size_t curve = 0; curve < connectorPoints.size(); ++curve)
+    {
+        const auto& points = connectorPoints[curve];
+        auto* curveSegments = snapshot.segments.data() + curve * maxConnectorsPerCurve;
+        auto getConnector = [&points](size_t i) { return points[i].ToDefinition(); };
+        for (auto i = pending[curve].firstSegment; i < std::min(pending[curve].endSegment, points.size()); ++i)
+        {
+            curveSegments[i] = SegmentBuilder::BuildSegment(getConnector, i, points.size());
+        }
+        pending[curve] = {};
+        jassert(points.empty() || juce::approximatelyEqual(points.back().end.x, 1.0f)); //there has to be a connector at the end!
+        snapshot.numSegments[curve] = points.size();
+    }
+    snapshots.Publish();
+}
+
+}
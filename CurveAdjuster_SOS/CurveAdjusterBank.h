@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    CurveAdjusterBank.h
+    Created: 17 Oct 2026 12:49:05pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ICurveAdjusterProcessor.h"
+#include "CurveStateSerialisation.h"
+#include "QuadraticSegment.h"
+#include "SegmentCursor.h"
+#include "SnapshotExchange.h"
+#include "VoiceSmoothers.h"
+
+namespace CurveAdjuster
+{
+    /*many curves (e.g. one per automatable parameter) in one object: every curve's segments sit in one
+     array and every smoother in VoiceSmoothers' arrays, so a block of all of them is one pass over
+     contiguous memory instead of a visit to each CurveAdjusterProcessor's own heap allocations.
+     each curve has a handle that saves and loads like a CurveAdjusterProcessor.
+     curves are fixed at construction, like a processor's maximum number of connectors*/
+    class CurveAdjusterBank
+    {
+    public:
+        //one curve of the bank, for save/load and editing
+        class Curve : public ICurveAdjusterProcessor
+        {
+        public:
+            Curve(CurveAdjusterBank& _bank, size_t _index, std::string n);
+
+            size_t GetNumConnectors() override;
+            uint64_t GetGeneration() const override;
+
+            void SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo) override;
+            void LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree) override;
+            const juce::Identifier& GetName() const override;
+
+            //same as CurveAdjusterProcessor::SetConnectors, not for the audio thread
+            void SetConnectors(const std::vector<ConnectorPoints>& newConnectorPoints);
+            std::vector<ConnectorPoints> GetConnectors() const;
+
+            size_t GetIndex() const;
+
+        protected:
+            void SetState(juce::ValueTree& curveAdjusterTree) override;
+            void RemoveThisCurveAdjusterTreeFromAPVTS(juce::ValueTree& apvtsTree, juce::ValueTree& curveAdjusterTree) override;
+
+        private:
+            CurveAdjusterBank& bank;
+            const size_t index;
+            const juce::Identifier name;
+        };
+
+        //one curve per name, each starting as the default linear ramp up
+        CurveAdjusterBank(const std::vector<std::string>& names, float initVal, double smoothingIncrement);
+
+        size_t GetNumCurves() const;
+        Curve& GetCurve(size_t index);
+
+        //audio thread, jumps every smoother to its target
+        void Reset(double sampleRate);
+
+        /*smooths curve c towards targets[c] and maps it into outputs[c] (numSamples values, nullptr to skip).
+         curves that aren't ramping are evaluated once for the block, the rest every sample*/
+        void ProcessBlock(const float* targets, float* const* outputs, int numSamples);
+
+        //one curve, one value, no smoothing. audio thread
+        float GetTranslatedOutput(size_t curve, float x);
+
+    private:
+        //every curve's segments, curve c owns maxSegmentsPerCurve of them from c * maxSegmentsPerCurve
+        struct BankSnapshot
+        {
+            BankSnapshot(size_t numCurves, size_t _maxSegmentsPerCurve);
+
+            float GetY_AtX(size_t curve, float in_X, SegmentCursor& cursor) const;
+
+            const size_t maxSegmentsPerCurve;
+            std::vector<QuadraticSegment> segments;
+            std::vector<size_t> numSegments;
+        };
+
+        using PendingRanges = std::array<std::vector<DirtyRange>, SnapshotExchange<BankSnapshot>::numBuffers>;
+
+        void SetConnectors(size_t curve, const std::vector<ConnectorPoints>& newConnectorPoints);
+        void PublishSnapshot(); //caller holds writerLock
+        static PendingRanges MakePendingRanges(size_t numCurves);
+
+        static constexpr size_t maxConnectorsPerCurve {CurveAdjusterProcessorData::defaultMaxConnectors};
+
+        juce::CriticalSection writerLock;
+        std::vector<std::vector<ConnectorPoints>> connectorPoints; //per curve, guarded by writerLock
+        std::vector<std::atomic<uint64_t>> generations;            //per curve, written under writerLock
+        PendingRanges pendingRanges; //per snapshot buffer and curve, the edits it's missing. guarded by writerLock
+
+        SnapshotExchange<BankSnapshot> snapshots;
+        VoiceSmoothers smoothers;           //one "voice" per curve
+        std::vector<SegmentCursor> cursors; //audio thread only
+        std::vector<int> rampingCurves;     //audio thread only, sized once
+
+        std::vector<Curve> curves;
+
+        JUCE_DECLARE_NON_COPYABLE(CurveAdjusterBank)
+    };
+}
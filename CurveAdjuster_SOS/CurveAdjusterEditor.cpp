@@ -108,23 +108,23 @@ void CurveAdjusterEditor::InitHandles()
     {
         connectors.clear();
     }
-    for (size_t i = 0; i < curveAdjusterProcessor.data.maxConnectors.load(); ++i)
+    const auto numConnectors = curveAdjusterProcessor.data.GetNumConnectors();
+    jassert(numConnectors > 0); //there should always be an end point!
+    for (size_t i = 0; i < numConnectors; ++i)
     {
         pointType start = GetCoordinateFromPercentage({curveAdjusterProcessor.data[i].startX.load(), curveAdjusterProcessor.data[i].startY.load()});
         pointType control = GetCoordinateFromPercentage({curveAdjusterProcessor.data[i].controlX.load(), curveAdjusterProcessor.data[i].controlY.load()});
         pointType end = GetCoordinateFromPercentage({curveAdjusterProcessor.data[i].endX.load(), curveAdjusterProcessor.data[i].endY.load()});
+        const auto type = static_cast<SegmentType>(curveAdjusterProcessor.data[i].type.load());
         
         AddHandle(start);
         
-        AddHandleConnection(start, control , end, connectors.end());
-        if (curveAdjusterProcessor.data[i].endX.load() == 1.0f)
+        AddHandleConnection(start, control , end, connectors.end(), type);
+        if (i + 1 == numConnectors)
         {
             AddHandle(end);
-            return;
         }
     }
-    
-    jassertfalse; //there should always be an end point!
 }
 
 void CurveAdjusterEditor::mouseEnter(const juce::MouseEvent& e)
@@ -398,35 +398,14 @@ void CurveAdjusterEditor::valueChanged(juce::Value& value)
     
     if ((bool)(handleChanged.getValue()) == true || (bool)replacementHappened.getValue() == true)
     {
-        //set last connector first! this way there is always an end
-        int index = static_cast<int>(connectors.size()) - 1;
-        for (auto it = connectors.rbegin(); it != connectors.rend(); ++it, --index)
+        //the processor receives the whole curve at once, so the audio thread never sees a partial edit
+        std::vector<ConnectorPoints> connectorPoints;
+        connectorPoints.reserve(connectors.size());
+        for (auto& c : connectors)
         {
-            auto start = GetPointAsPercentage(it->start);
-            curveAdjusterProcessor.data[index].startX.store(start.x);
-            curveAdjusterProcessor.data[index].startY.store(start.y);
-            
-            auto control = GetPointAsPercentage(it->control);
-            curveAdjusterProcessor.data[index].controlX.store(control.x);
-            curveAdjusterProcessor.data[index].controlY.store(control.y);
-            
-            auto end = GetPointAsPercentage(it->end);
-            curveAdjusterProcessor.data[index].endX.store(end.x);
-            curveAdjusterProcessor.data[index].endY.store(end.y);
-        }
-        
-        //clear rest of data set
-        auto remainderIndex = static_cast<size_t>(connectors.size());
-        while (remainderIndex < curveAdjusterProcessor.data.maxConnectors.load())
-        {
-            curveAdjusterProcessor.data[remainderIndex].startX.store(-1.0f);
-            curveAdjusterProcessor.data[remainderIndex].startY.store(-1.0f);
-            curveAdjusterProcessor.data[remainderIndex].controlX.store(-1.0f);
-            curveAdjusterProcessor.data[remainderIndex].controlY.store(-1.0f);
-            curveAdjusterProcessor.data[remainderIndex].endX.store(-1.0f);
-            curveAdjusterProcessor.data[remainderIndex].endY.store(-1.0f);
-            ++remainderIndex;
+            connectorPoints.push_back({GetPointAsPercentage(c.start), GetPointAsPercentage(c.control), GetPointAsPercentage(c.end), c.type});
         }
+        curveAdjusterProcessor.SetConnectors(connectorPoints);
         
         if ((bool)handleChanged.getValue() == true)
         {
@@ -713,7 +692,7 @@ std::vector<pointType> CurveAdjusterEditor::GetControlPointCoordinates()
 
 bool CurveAdjusterEditor::AddHandle(pointType p)
 {
-    if (connectors.size() >= curveAdjusterProcessor.data.maxConnectors.load())
+    if (connectors.size() >= curveAdjusterProcessor.data.GetMaxConnectors())
     {
         return false; //can't add any more points, so return false
     }
@@ -864,7 +843,7 @@ void CurveAdjusterEditor::ReplaceState(const Connector::connectorsCollection& c)
                 if (connectorsIt != c.end())
                 {
                     auto controlP = connectorsIt->control;
-                    AddHandleConnection((*it)->GetPos(), controlP ,(*next)->GetPos(), connectors.end());
+                    AddHandleConnection((*it)->GetPos(), controlP ,(*next)->GetPos(), connectors.end(), connectorsIt->type);
                 }
             }
         }
@@ -1128,25 +1107,41 @@ pointType CurveAdjusterEditor::GetCoordinateFromPercentage(pointType p)
 }
 
 //todo / dream list, have connectors set their own control points to curve fit smoothly
-void CurveAdjusterEditor::AddHandleConnection(pointType start, pointType end, Connector::connectorsCollectionIterator it)
+void CurveAdjusterEditor::AddHandleConnection(pointType start, pointType end, Connector::connectorsCollectionIterator it, SegmentType type)
 {
-    Connector newConnector{start, end};
+    Connector newConnector{start, end, type};
     
     auto thisConnector = connectors.insert(it, newConnector);
     thisConnector->setBounds(0, 0, getWidth(), getHeight());
+    thisConnector->SetFrame(GetWidth(), GetHeight());
+    LinkConnectors();
     addAndMakeVisible(*thisConnector);
     repaint();
 }
 
 //for adding connector when control point is known
-void CurveAdjusterEditor::AddHandleConnection(pointType start, pointType control, pointType end, Connector::connectorsCollectionIterator it)
+void CurveAdjusterEditor::AddHandleConnection(pointType start, pointType control, pointType end, Connector::connectorsCollectionIterator it, SegmentType type)
 {
-    auto thisConnector = connectors.insert(it, Connector(start, control, end));
+    auto thisConnector = connectors.insert(it, Connector(start, control, end, type));
     thisConnector->setBounds(0, 0, getWidth(), getHeight());
+    thisConnector->SetFrame(GetWidth(), GetHeight());
+    LinkConnectors();
     addAndMakeVisible(*thisConnector);
     repaint();
 }
 
+void CurveAdjusterEditor::LinkConnectors()
+{
+    Connector* previous = nullptr;
+    for (auto it = connectors.begin(); it != connectors.end(); ++it)
+    {
+        auto next = std::next(it);
+        it->SetNeighbours(previous, next != connectors.end() ? &*next : nullptr);
+        it->repaint();
+        previous = &*it;
+    }
+}
+
 void CurveAdjusterEditor::RedrawConnectorsAfterHandleRemoved(Connector::connectorsCollectionIterator it, pointType newStart, pointType newEnd)
 {
     //this should be at least the second connector path
@@ -1155,25 +1150,30 @@ void CurveAdjusterEditor::RedrawConnectorsAfterHandleRemoved(Connector::connecto
     auto previousIt = it;
     --previousIt;
 
+    //the merged connector keeps the type of the one before the removed handle
+    const auto type = previousIt->type;
     previousIt = connectors.erase(previousIt);
     previousIt = connectors.erase(previousIt);
-    AddHandleConnection(newStart, newEnd, previousIt);
+    AddHandleConnection(newStart, newEnd, previousIt, type);
 }
 
 
 //expects connector iterator AT connector path to remove and be replaced by two new ones
 void CurveAdjusterEditor::RedrawConnectorsAfterHandleAdded(Connector::connectorsCollectionIterator it, pointType start, pointType middle, pointType end)
 {
+    //both halves keep the split connector's type
+    const auto type = it->type;
     it = connectors.erase(it);
-    AddHandleConnection(start, middle, it);
-    AddHandleConnection(middle, end, it);
+    AddHandleConnection(start, middle, it, type);
+    AddHandleConnection(middle, end, it, type);
 }
 
 //for redrawing a connector when a handle moved at either the beginning or the end
 void CurveAdjusterEditor::RedrawConnectorsAfterHandleMoved(Connector::connectorsCollectionIterator it, pointType start, pointType end)
 {
+    const auto type = it->type;
     it = connectors.erase(it);
-    AddHandleConnection(start, end, it);
+    AddHandleConnection(start, end, it, type);
 }
 
 void CurveAdjusterEditor::RedrawConnectorsAfterHandleMoved(Connector::connectorsCollectionIterator it, pointType movedHandlePoint)
@@ -1223,7 +1223,7 @@ void CurveAdjusterEditor::ReplaceStateFromUndoManagerConnectors(Connector::conne
                 
                 if (connectorIt != _c.end())
                 {
-                    AddHandleConnection((*it)->GetPos(), connectorIt->control, (*next)->GetPos(), connectors.end());
+                    AddHandleConnection((*it)->GetPos(), connectorIt->control, (*next)->GetPos(), connectors.end(), connectorIt->type);
                 }
             }
         }
@@ -1260,9 +1260,40 @@ void CurveAdjusterEditor::HandleRightClickOptionsNoMultiSelect()
         rampDownSubmenu.addItem(13, "binary");
         m.addSubMenu("ramp down", rampDownSubmenu);
     }
+    
+    //the connector under the mouse can have its segment type chosen
+    auto mouseOverConnector = std::find_if(connectors.begin(), connectors.end(), [](const Connector& c) { return c.mouseOver; });
+    const auto connectorIndex = std::distance(connectors.begin(), mouseOverConnector);
+    if (mouseOverConnector != connectors.end())
+    {
+        juce::PopupMenu segmentTypeSubmenu;
+        const std::pair<SegmentType, const char*> segmentTypes[] {{SegmentType::automatic, "automatic"}, {SegmentType::linear, "linear"},
+                                                                  {SegmentType::hold, "hold"}, {SegmentType::quadratic, "quadratic"},
+                                                                  {SegmentType::monotoneCubic, "smooth (monotone cubic)"}};
+        for (const auto& [segmentType, typeName] : segmentTypes)
+        {
+            segmentTypeSubmenu.addItem(segmentTypeMenuOffset + static_cast<int>(segmentType), typeName, true, mouseOverConnector->type == segmentType);
+        }
+        m.addSubMenu("segment type", segmentTypeSubmenu);
+    }
+    
     m.showMenuAsync(juce::PopupMenu::Options(),
-                    [this] (int result)
+                    [this, connectorIndex] (int result)
     {
+        if (result >= segmentTypeMenuOffset)
+        {
+            //the list may have changed while the menu was open
+            if (connectorIndex < static_cast<std::ptrdiff_t>(connectors.size()))
+            {
+                auto c = std::next(connectors.begin(), connectorIndex);
+                c->type = static_cast<SegmentType>(result - segmentTypeMenuOffset);
+                c->SetPath();
+                c->repaint();
+                handleChanged.setValue(true);
+                undoManager.AddState(connectors);
+            }
+            return;
+        }
 
         if (result == 1) //flat line bottom
         {
@@ -1386,7 +1417,7 @@ void CurveAdjusterEditor::HandleRightClickOptionsInMultiSelect()
     juce::PopupMenu m;
     juce::PopupMenu randomSubmenu;
     randomSubmenu.addItem(1, "randomize selection");
-    if (connectors.size() < curveAdjusterProcessor.data.maxConnectors.load())
+    if (connectors.size() < curveAdjusterProcessor.data.GetMaxConnectors())
     {
         randomSubmenu.addItem(2, "add handle");
     }
@@ -1620,11 +1651,6 @@ void CurveAdjusterEditor::AddPairToNewlyReplacedSelection(const std::pair<pointT
 
 void CurveAdjusterEditor::PrintControlPoints()
 {
-    DBG(curveAdjusterProcessor.GetName() << ":");
-    for (auto& c : connectors)
-    {
-        DBG("{{" << DebugHelp::GetPointAsString(c.start) << "}, " <<
-            "{" << DebugHelp::GetPointAsString(c.control) << "}, " <<
-            "{" << DebugHelp::GetPointAsString(c.end) << "}}, ");
-    }
+    //paste into a header, then pass the Baked curve to the CurveAdjusterProcessor constructor
+    DBG(curveAdjusterProcessor.ExportAsCppHeader(curveAdjusterProcessor.GetName().toString() + "Curve"));
 }
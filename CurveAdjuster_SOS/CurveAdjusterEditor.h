@@ -109,12 +109,13 @@ private:
     
     //concerning connectors
     void DetermineMouseOverConnectors(const juce::Point<float> p);
-    void AddHandleConnection(pointType start, pointType end, Connector::connectorsCollectionIterator it);
-    void AddHandleConnection(pointType start, pointType control, pointType end, Connector::connectorsCollectionIterator it);
+    void AddHandleConnection(pointType start, pointType end, Connector::connectorsCollectionIterator it, SegmentType type = SegmentType::automatic);
+    void AddHandleConnection(pointType start, pointType control, pointType end, Connector::connectorsCollectionIterator it, SegmentType type = SegmentType::automatic);
     void RedrawConnectorsAfterHandleRemoved(Connector::connectorsCollectionIterator it, pointType newStart, pointType newEnd);
     void RedrawConnectorsAfterHandleAdded(Connector::connectorsCollectionIterator it, pointType start, pointType middle, pointType end);
     void RedrawConnectorsAfterHandleMoved(Connector::connectorsCollectionIterator it, pointType start, pointType end);
     void RedrawConnectorsAfterHandleMoved(Connector::connectorsCollectionIterator it, pointType movedHandlePoint);
+    void LinkConnectors(); //after any insert, so each connector knows its neighbours
     
     //this keeps track of the associated parameters value for drawing reference
     juce::Value paramValue;
@@ -141,6 +142,7 @@ private:
     bool minIsAdjustable, maxIsAdjustable;
     
     void HandleRightClickOptionsNoMultiSelect();
+    const int segmentTypeMenuOffset {100}; //menu ids for the segment types are this plus the SegmentType
     
     MultiSelectManager multiSelectManager;
     void HandleRightClickOptionsInMultiSelect();
@@ -150,7 +152,7 @@ private:
     void HandleSelectionReplacement(std::pair<pointType, pointType> p);
     void AddPairToNewlyReplacedSelection(const std::pair<pointType, pointType>& p);
     
-    //for creating presets
+    //for creating presets, prints the curve as a header to bake (see CurveAdjusterProcessor::ExportAsCppHeader)
     void PrintControlPoints();
 };
 
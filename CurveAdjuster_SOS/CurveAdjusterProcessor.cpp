@@ -13,22 +13,34 @@
 namespace CurveAdjuster
 {
 
-CurveAdjusterProcessor::CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints)
+CurveAdjusterProcessor::CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints, size_t maxConnectors)
+: CurveAdjusterProcessor(n, initVal, smoothingIncrement, std::move(_connnectorPoints), maxConnectors, nullptr, 0)
+{
+}
+
+CurveAdjusterProcessor::CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints,
+                                               size_t maxConnectors, const float* bakedTable, size_t bakedTableSize)
 :
+data(maxConnectors),
 smoothedVal(initVal, smoothingIncrement),
+snapshots(CurveSnapshot(data.GetMaxConnectors())),
 name(n)
 {
-    int connectorIndex = 0;
-    for (auto& c : _connnectorPoints)
     {
-        data[connectorIndex].startX = c.start.x;
-        data[connectorIndex].startY = c.start.y;
-        data[connectorIndex].controlX = c.control.x;
-        data[connectorIndex].controlY = c.control.y;
-        data[connectorIndex].endX = c.end.x;
-        data[connectorIndex].endY = c.end.y;
-        ++connectorIndex;
+        const juce::ScopedLock lock(writerLock);
+        pendingRanges.fill(DirtyRange::All());
+        StoreConnectors(_connnectorPoints);
+        if (bakedTable != nullptr)
+        {
+            //a baked curve starts in lookup table mode, so edits resample a table of the same size
+            jassert(bakedTableSize >= CurveLookupTable::minNumPoints);
+            lookupTableSize = bakedTableSize;
+            lookupTableFormat = LookupTableFormat::floatingPoint;
+        }
+        PublishSnapshot(bakedTable, bakedTableSize);
     }
+    //take the first curve now so processing doesn't begin by crossfading in from an empty one
+    snapshots.Update();
     //this flag set after default values have been added
     defaultDataAdded = true;
 }
@@ -41,66 +53,29 @@ CurveAdjusterProcessor::CurveAdjusterProcessor(std::string n, float initVal, dou
 
 CurveAdjusterProcessor::~CurveAdjusterProcessor()
 {
+    //the compiler mustn't be left holding this
+    SetBackgroundCompilation(false);
 }
 
 size_t CurveAdjusterProcessor::GetNumConnectors()
 {
-    for (size_t i = 0; i < data.maxConnectors.load(); ++i)
-    {
-        if (data[i].endX == 1.0f)
-        {
-            return ++i;
-        }
-    }
-    jassert(false); //there has to be a connector at the end!
-    return 0; //TODO: make return type optional?
+    return data.GetNumConnectors();
 }
 
 
+uint64_t CurveAdjusterProcessor::GetGeneration() const
+{
+    return generation.load(std::memory_order_acquire);
+}
+
 void CurveAdjusterProcessor::SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo)
 {
     //use this to clear the points if needed when debugging
     //return;
     
     //DBG("saving");
-    juce::ValueTree temp
-    { name, {},
-        {
-            { connectors_ID , {},}
-        }
-    };
-    
-    //iterate through any handles and add to the temp tree
-    for (size_t i = 0; i < GetNumConnectors(); ++i)
-    {
-        //create tree for the point
-        juce::Identifier connectorName = juce::String("connector" + std::to_string(i));
-        juce::ValueTree connectorTree
-        { connectorName, {},
-            {
-                {"startX", {{value_string_as_ID, data[i].startX.load()}}},
-                {"startY", {{value_string_as_ID, data[i].startY.load()}}},
-                {"controlX", {{value_string_as_ID, data[i].controlX.load()}}},
-                {"controlY", {{value_string_as_ID, data[i].controlY.load()}}},
-                {"endX", {{value_string_as_ID, data[i].endX.load()}}},
-                {"endY", {{value_string_as_ID, data[i].endY.load()}}}
-            }
-        };
-        
-        //add pointTree to "handle coordinates" in temptree
-        temp.getChildWithName(connectors_ID).appendChild(connectorTree, nullptr);
-    }
-    
-    //DBG(temp.toXmlString());
-    
-    if (stateToAppendTo.state.getChildWithName(name).isValid())
-    {
-        stateToAppendTo.state.getChildWithName(name).copyPropertiesAndChildrenFrom(temp, nullptr);
-    }
-    else
-    {
-        stateToAppendTo.state.appendChild(temp, nullptr);
-    }
+    const juce::ScopedLock lock(writerLock);
+    CurveStateSerialisation::Save(stateToAppendTo, name, connectorPoints);
 }
 
 void CurveAdjusterProcessor::LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree)
@@ -127,50 +102,340 @@ float CurveAdjusterProcessor::GetTranslatedOutput(float in_X)
     inputX.set(in_X); //for drawing traces
 
     //jassert(in_X >= 0.0f); //negative input is bad input!
-    if (in_X <= 0.0f) in_X = 0.0f;
+    in_X = juce::jlimit(0.0f, 1.0f, in_X);
+    
+    const auto& snapshot = AcquireSnapshot();
+    auto y = snapshot.GetY_AtX(in_X, audioThreadCursor);
+    if (crossfadeRemaining > 0)
+    {
+        const auto previousY = snapshots.Get(1).GetY_AtX(in_X, previousSnapshotCursor);
+        y = previousY + GetCrossfadeGain(0) * (y - previousY);
+        --crossfadeRemaining;
+    }
+    return y;
+}
+
+CurveValueAndSlope CurveAdjusterProcessor::GetTranslatedOutputWithSlope(float in_X)
+{
+    inputX.set(in_X); //for drawing traces
+    in_X = juce::jlimit(0.0f, 1.0f, in_X);
+    
+    const auto& snapshot = AcquireSnapshot();
+    auto result = snapshot.GetY_AndSlope_AtX(in_X, audioThreadCursor);
+    if (crossfadeRemaining > 0)
+    {
+        //the fade is a blend with a gain that doesn't depend on x, so the slopes blend the same way
+        const auto previous = snapshots.Get(1).GetY_AndSlope_AtX(in_X, previousSnapshotCursor);
+        const auto gain = GetCrossfadeGain(0);
+        result.y = previous.y + gain * (result.y - previous.y);
+        result.slope = previous.slope + gain * (result.slope - previous.slope);
+        result.segmentMaxSlope = juce::jmax(result.segmentMaxSlope, previous.segmentMaxSlope);
+        --crossfadeRemaining;
+    }
+    return result;
+}
+
+float CurveAdjusterProcessor::GetMaxSlope() const
+{
+    return maxSlope.load(std::memory_order_relaxed);
+}
+
+void CurveAdjusterProcessor::ProcessBlock(const float* in, float* out, int numSamples)
+{
+    if (numSamples <= 0)
+    {
+        return;
+    }
+    inputX.set(in[numSamples - 1]); //for drawing traces, read before in place processing overwrites it
+    ProcessWithCrossfade(AcquireSnapshot(), in, out, numSamples);
+    crossfadeRemaining -= juce::jmin(crossfadeRemaining, numSamples);
+}
+
+void CurveAdjusterProcessor::ProcessBlock(juce::dsp::AudioBlock<float>& block)
+{
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    if (numSamples == 0 || block.getNumChannels() == 0)
+    {
+        return;
+    }
+    inputX.set(block.getSample(0, numSamples - 1)); //for drawing traces
+    const auto& snapshot = AcquireSnapshot();
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+    {
+        //every channel fades the same samples, so the fade only moves on after the last one
+        auto* samples = block.getChannelPointer(channel);
+        ProcessWithCrossfade(snapshot, samples, samples, numSamples);
+    }
+    crossfadeRemaining -= juce::jmin(crossfadeRemaining, numSamples);
+}
+
+void CurveAdjusterProcessor::ProcessSmoothedBlock(float target, float* out, int numSamples)
+{
+    const auto isConstant = smoothedVal.GetNextBlock(target, out, numSamples);
+    AcquireSnapshot();
+    if (isConstant && crossfadeRemaining == 0)
+    {
+        juce::FloatVectorOperations::fill(out, GetTranslatedOutput(smoothedVal.value), numSamples);
+        return;
+    }
+    ProcessBlock(out, out, numSamples);
+}
+
+void CurveAdjusterProcessor::ProcessVoices(VoiceSmoothers& voices, float* const* voiceOutputs, int numSamples)
+{
+    const auto& snapshot = AcquireSnapshot();
+    const auto numActive = voices.GatherActiveVoices(voiceOutputs);
+    const auto* activeVoices = voices.GetActiveVoices();
+    auto* curveOutput = voices.GetCurveOutput();
+    auto* crossfadeOutput = voices.GetCrossfadeOutput();
     
-    //find points at which in_X lies between
-    auto numConnectors = GetNumConnectors();
-    for (size_t i = 0; i < numConnectors; ++i)
+    if (numActive == 0)
     {
-        if (data[i].startX < in_X && data[i].endX > in_X)
+        //nothing to write, the ramps and the fade still move on
+        for (int sample = 0; sample < numSamples; ++sample)
         {
-            return GetY_AtX(data[i], in_X);
+            voices.Advance();
         }
-        
-        //simplified path if in_X equals start or end of segment
-        if (juce::approximatelyEqual(data[i].startX.load(), in_X))
+        crossfadeRemaining -= juce::jmin(crossfadeRemaining, numSamples);
+        return;
+    }
+    
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        voices.Advance();
+        const auto* activeValues = voices.GetActiveValues();
+        snapshot.Process(activeValues, curveOutput, numActive);
+        if (crossfadeRemaining > 0)
         {
-            return data[i].startY;
+            snapshots.Get(1).Process(activeValues, crossfadeOutput, numActive);
+            const auto gain = GetCrossfadeGain(0);
+            for (int i = 0; i < numActive; ++i)
+            {
+                curveOutput[i] = crossfadeOutput[i] + gain * (curveOutput[i] - crossfadeOutput[i]);
+            }
+            --crossfadeRemaining;
         }
-        if (juce::approximatelyEqual(data[i].endX.load(), in_X))
+        for (int i = 0; i < numActive; ++i)
         {
-            return data[i].endY;
+            voiceOutputs[activeVoices[i]][sample] = curveOutput[i];
         }
     }
+    
+    //for drawing traces, follow the first voice that is playing
+    inputX.set(voices.GetCurrentValues()[activeVoices[0]]);
+}
+
+float CurveAdjusterProcessor::GetInputForOutput(float y) const
+{
+    const juce::ScopedLock lock(writerLock);
+    
+    //closest output so far, in case no segment reaches y
+    auto closestX = 0.0f;
+    auto closestDistance = std::numeric_limits<float>::max();
+    auto considerT = [&](const QuadraticSegment& segment, float t)
+    {
+        const auto distance = std::abs(segment.GetY_AtT(t) - y);
+        if (distance < closestDistance)
+        {
+            closestDistance = distance;
+            closestX = segment.GetX_AtT(t);
+        }
+    };
+    
+    //connectors are in x order and x grows with t, so the first root found is the smallest input
+    for (size_t i = 0; i < connectorPoints.size(); ++i)
+    {
+        const auto segment = SegmentBuilder::BuildSegment([this](size_t j) { return connectorPoints[j].ToDefinition(); }, i, connectorPoints.size());
+        float roots[2];
+        if (segment.GetT_AtY(y, roots) > 0)
+        {
+            return juce::jlimit(0.0f, 1.0f, segment.GetX_AtT(roots[0]));
+        }
+        considerT(segment, 0.0f);
+        //a monotone cubic has no turning point inside
+        if (segment.type == SegmentType::quadratic && std::abs(segment.ay) > QuadraticSegment::minDenominator)
+        {
+            considerT(segment, juce::jlimit(0.0f, 1.0f, -segment.by / (2.0f * segment.ay)));
+        }
+        considerT(segment, 1.0f);
+    }
+    return juce::jlimit(0.0f, 1.0f, closestX);
+}
 
-    //jassert(false); //should have found a compatible x!
-    return 0.0f;
+void CurveAdjusterProcessor::PrepareWaveshaper(const juce::dsp::ProcessSpec& spec, WaveshaperOversampling oversampling)
+{
+    const auto factorLog2 = oversampling == WaveshaperOversampling::times4 ? 2 : oversampling == WaveshaperOversampling::times2 ? 1 : 0;
+    waveshaperOversampling = std::make_unique<juce::dsp::Oversampling<float>>(spec.numChannels, static_cast<size_t>(factorLog2),
+                                                                             juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR);
+    waveshaperOversampling->initProcessing(static_cast<size_t>(spec.maximumBlockSize));
+    waveshaperPreviousInputs.assign(spec.numChannels, 0.0f);
 }
 
-void CurveAdjusterProcessor::SetState(juce::ValueTree& curveAdjusterTree)
+void CurveAdjusterProcessor::ResetWaveshaper()
 {
-    auto setOfConnectorsChild = curveAdjusterTree.getChildWithName(connectors_ID);
-    if (!setOfConnectorsChild.isValid())
+    if (waveshaperOversampling != nullptr)
+    {
+        waveshaperOversampling->reset();
+    }
+    std::fill(waveshaperPreviousInputs.begin(), waveshaperPreviousInputs.end(), 0.0f);
+}
+
+void CurveAdjusterProcessor::ProcessWaveshaper(juce::dsp::AudioBlock<float>& block)
+{
+    jassert(waveshaperOversampling != nullptr); //call PrepareWaveshaper first!
+    jassert(block.getNumChannels() <= waveshaperPreviousInputs.size());
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+    if (numSamples == 0 || block.getNumChannels() == 0 || waveshaperOversampling == nullptr)
     {
         return;
     }
+    inputX.set(0.5f * (block.getSample(0, numSamples - 1) + 1.0f)); //for drawing traces
+    
+    const auto& snapshot = AcquireSnapshot();
+    auto oversampledBlock = waveshaperOversampling->processSamplesUp(block);
+    const auto factor = static_cast<int>(waveshaperOversampling->getOversamplingFactor());
+    for (size_t channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
+    {
+        ShapeWithCrossfade(snapshot, oversampledBlock.getChannelPointer(channel), numSamples * factor, waveshaperPreviousInputs[channel], factor);
+    }
+    crossfadeRemaining -= juce::jmin(crossfadeRemaining, numSamples);
+    waveshaperOversampling->processSamplesDown(block);
+}
+
+float CurveAdjusterProcessor::GetWaveshaperLatency() const
+{
+    //ADAA's output is centred between the last two inputs
+    const auto antialiasingLatency = 0.5f;
+    if (waveshaperOversampling == nullptr)
+    {
+        return antialiasingLatency;
+    }
+    return waveshaperOversampling->getLatencyInSamples() + antialiasingLatency / static_cast<float>(waveshaperOversampling->getOversamplingFactor());
+}
+
+void CurveAdjusterProcessor::ShapeWithCrossfade(const CurveSnapshot& snapshot, float* samples, int numSamples, float& previousInput, int samplesPerFadeStep)
+{
+    const auto fadingSamples = juce::jmin(crossfadeRemaining * samplesPerFadeStep, numSamples);
+    if (fadingSamples > 0)
+    {
+        const auto& previous = snapshots.Get(1);
+        float previousOut[crossfadeChunkSize];
+        for (int start = 0; start < fadingSamples; start += crossfadeChunkSize)
+        {
+            const auto chunk = juce::jmin(crossfadeChunkSize, fadingSamples - start);
+            const auto nextPreviousInput = samples[start + chunk - 1];
+            //previous first, the current shape overwrites the input
+            ShapeAntialiased(previous, samples + start, previousOut, chunk, previousInput);
+            ShapeAntialiased(snapshot, samples + start, samples + start, chunk, previousInput);
+            for (int i = 0; i < chunk; ++i)
+            {
+                const auto gain = GetCrossfadeGain((start + i) / samplesPerFadeStep);
+                samples[start + i] = previousOut[i] + gain * (samples[start + i] - previousOut[i]);
+            }
+            previousInput = nextPreviousInput;
+        }
+    }
+    if (fadingSamples < numSamples)
+    {
+        const auto nextPreviousInput = samples[numSamples - 1];
+        ShapeAntialiased(snapshot, samples + fadingSamples, samples + fadingSamples, numSamples - fadingSamples, previousInput);
+        previousInput = nextPreviousInput;
+    }
+}
+
+void CurveAdjusterProcessor::ShapeAntialiased(const CurveSnapshot& snapshot, const float* in, float* out, int numSamples, float previousInput)
+{
+    /*bipolar shaper g(x) = 2 * f((x + 1) / 2) - 1, whose antiderivative is G(x) = 4 * F((x + 1) / 2) - x.
+     the previous antiderivative is recomputed from the input, so it always belongs to this snapshot*/
+    auto getAntiderivative = [&](double x)
+    {
+        return 4.0 * snapshot.GetAntiderivative(0.5 * (x + 1.0), waveshaperCursor) - x;
+    };
+    
+    auto previousX = static_cast<double>(previousInput);
+    auto previousAntiderivative = getAntiderivative(previousX);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = static_cast<double>(in[i]);
+        const auto antiderivative = getAntiderivative(x);
+        const auto difference = x - previousX;
+        if (std::abs(difference) > antiderivativeTolerance)
+        {
+            out[i] = static_cast<float>((antiderivative - previousAntiderivative) / difference);
+        }
+        else
+        {
+            //too close to divide, the mean is then the curve at the midpoint
+            const auto midpoint = juce::jlimit(0.0f, 1.0f, static_cast<float>(0.25 * (x + previousX) + 0.5));
+            out[i] = 2.0f * snapshot.GetY_FromSegments(midpoint, waveshaperCursor) - 1.0f;
+        }
+        previousX = x;
+        previousAntiderivative = antiderivative;
+    }
+}
+
+void CurveAdjusterProcessor::SetShapeCrossfadeLength(double seconds, double sampleRate)
+{
+    crossfadeLength.store(juce::jmax(0, juce::roundToInt(seconds * sampleRate)));
+}
+
+const CurveSnapshot& CurveAdjusterProcessor::AcquireSnapshot()
+{
+    /*a change arriving mid fade waits in the exchange until the fade is over, restarting the fade
+     from the shape it was heading to would jump by whatever was left of it. edits published in the
+     meantime replace the waiting one, so the next fade goes straight to the newest shape*/
+    if (crossfadeRemaining == 0)
+    {
+        //without a fade the one before the newest is never read, so it's parked for the writer to empty
+        const auto newCrossfadeLength = crossfadeLength.load(std::memory_order_relaxed);
+        snapshots.SetNumInUse(newCrossfadeLength > 0 ? 2 : 1);
+        if (snapshots.Update() && snapshots.GetNumInUse() == 2)
+        {
+            activeCrossfadeLength = newCrossfadeLength;
+            crossfadeRemaining = activeCrossfadeLength;
+        }
+    }
+    return snapshots.Get();
+}
+
+float CurveAdjusterProcessor::GetCrossfadeGain(int samplesAhead) const
+{
+    const auto samplesDone = activeCrossfadeLength - crossfadeRemaining + samplesAhead + 1;
+    return static_cast<float>(samplesDone) / static_cast<float>(activeCrossfadeLength);
+}
+
+void CurveAdjusterProcessor::ProcessWithCrossfade(const CurveSnapshot& snapshot, const float* in, float* out, int numSamples)
+{
+    const auto fadingSamples = juce::jmin(crossfadeRemaining, numSamples);
+    if (fadingSamples > 0)
+    {
+        const auto& previous = snapshots.Get(1);
+        float previousOut[crossfadeChunkSize];
+        for (int start = 0; start < fadingSamples; start += crossfadeChunkSize)
+        {
+            const auto chunk = juce::jmin(crossfadeChunkSize, fadingSamples - start);
+            //previous first, in may be the same buffer as out
+            previous.Process(in + start, previousOut, chunk);
+            snapshot.Process(in + start, out + start, chunk);
+            for (int i = 0; i < chunk; ++i)
+            {
+                const auto gain = GetCrossfadeGain(start + i);
+                out[start + i] = previousOut[i] + gain * (out[start + i] - previousOut[i]);
+            }
+        }
+    }
+    snapshot.Process(in + fadingSamples, out + fadingSamples, numSamples - fadingSamples);
+}
 
-    for (auto i = 0; i < setOfConnectorsChild.getNumChildren(); ++i)
+void CurveAdjusterProcessor::SetState(juce::ValueTree& curveAdjusterTree)
+{
+    std::vector<ConnectorPoints> loadedPoints;
+    if (! CurveStateSerialisation::Load(curveAdjusterTree, loadedPoints, data.GetMaxConnectors()))
     {
-        auto connectorChild = setOfConnectorsChild.getChild(i);
-        data[i].startX.store((float)connectorChild.getChildWithName("startX").getProperty(value_string_as_ID, -2.0));
-        data[i].startY.store((float)connectorChild.getChildWithName("startY").getProperty(value_string_as_ID, -1.0));
-        data[i].controlX.store((float)connectorChild.getChildWithName("controlX").getProperty(value_string_as_ID, -1.0));
-        data[i].controlY.store((float)connectorChild.getChildWithName("controlY").getProperty(value_string_as_ID, -1.0));
-        data[i].endX.store((float)connectorChild.getChildWithName("endX").getProperty(value_string_as_ID, -1.0));
-        data[i].endY.store((float)connectorChild.getChildWithName("endY").getProperty(value_string_as_ID, -1.0));
+        return;
     }
+    //whole preset goes to the audio thread as one snapshot
+    SetConnectors(loadedPoints);
     
     ReadyForGuiInit = true;
 }
@@ -180,47 +445,394 @@ void CurveAdjusterProcessor::RemoveThisCurveAdjusterTreeFromAPVTS(juce::ValueTre
     apvtsTree.removeChild(curveAdjusterTree, nullptr);
 }
 
-float CurveAdjusterProcessor::GetY_AtX(const AtomicConnector& c, float in_X)
+void CurveAdjusterProcessor::SetConnectors(const std::vector<ConnectorPoints>& newConnectorPoints)
+{
+    {
+        const juce::ScopedLock lock(writerLock);
+        if (! StoreConnectors(newConnectorPoints))
+        {
+            return;
+        }
+        RequestPublish();
+    }
+    //outside the lock, listeners may read other processors' curves
+    listeners.call([this](Listener& l) { l.CurveChanged(*this); });
+}
+
+std::vector<ConnectorPoints> CurveAdjusterProcessor::GetConnectors() const
 {
-//    const pointType start {c.startX.load(), c.startY.load()};
-//    const pointType control {c.controlX.load(), c.controlY.load()};
-//    const pointType end {c.endX.load(), c.endY.load()};
+    const juce::ScopedLock lock(writerLock);
+    return connectorPoints;
+}
+
+void CurveAdjusterProcessor::AddListener(Listener* listener)
+{
+    listeners.add(listener);
+}
+
+void CurveAdjusterProcessor::RemoveListener(Listener* listener)
+{
+    listeners.remove(listener);
+}
+
+CurveSnapshot CurveAdjusterProcessor::GetCurveCopy() const
+{
+    const juce::ScopedLock lock(writerLock);
+    CurveSnapshot snapshot(data.GetMaxConnectors());
+    BuildSegments(snapshot, connectorPoints, generation.load(std::memory_order_relaxed), DirtyRange::All());
+    return snapshot;
+}
+
+bool CurveAdjusterProcessor::StoreConnectors(const std::vector<ConnectorPoints>& newConnectorPoints)
+{
+    const auto maxConnectors = data.GetMaxConnectors();
+    if (newConnectorPoints.size() > maxConnectors)
+    {
+        jassertfalse; //too many connectors!
+        return StoreConnectors({newConnectorPoints.begin(), newConnectorPoints.begin() + static_cast<std::ptrdiff_t>(maxConnectors)});
+    }
     
-    //jassert(start.x - 2.0f * control.x + end.x != 0.0f); //this should already be addressed
+    const auto dirty = FindDirtyRange(connectorPoints, newConnectorPoints);
+    if (dirty.IsEmpty())
+    {
+        return false;
+    }
+    connectorPoints = newConnectorPoints;
+    generation.fetch_add(1, std::memory_order_release);
+    for (auto& pending : pendingRanges)
+    {
+        pending.Add(dirty);
+    }
     
+    //only the connectors that changed, ones no longer used are cleared to -1
+    for (auto i = dirty.firstSegment; i < std::min(dirty.endSegment, maxConnectors); ++i)
+    {
+        const auto isUsed = i < connectorPoints.size();
+        data[i].startX.store(isUsed ? connectorPoints[i].start.x : -1.0f);
+        data[i].startY.store(isUsed ? connectorPoints[i].start.y : -1.0f);
+        data[i].controlX.store(isUsed ? connectorPoints[i].control.x : -1.0f);
+        data[i].controlY.store(isUsed ? connectorPoints[i].control.y : -1.0f);
+        data[i].endX.store(isUsed ? connectorPoints[i].end.x : -1.0f);
+        data[i].endY.store(isUsed ? connectorPoints[i].end.y : -1.0f);
+        data[i].type.store(static_cast<int>(isUsed ? connectorPoints[i].type : SegmentType::automatic));
+    }
+    data.SetNumConnectors(connectorPoints.size());
+    return true;
+}
+
+void CurveAdjusterProcessor::EnableLookupTable(size_t numPoints, LookupTableFormat format)
+{
+    const juce::ScopedLock lock(writerLock);
+    lookupTableSize = std::max(numPoints, CurveLookupTable::minNumPoints);
+    lookupTableFormat = format;
+    adaptiveTableMaxError = 0.0f;
+    RequestPublish();
+}
+
+AdaptiveTableReport CurveAdjusterProcessor::EnableAdaptiveLookupTable(float maxError)
+{
+    const juce::ScopedLock lock(writerLock);
+    jassert(maxError > 0.0f);
+    lookupTableSize = 0;
+    adaptiveTableMaxError = juce::jmax(maxError, 1.0e-7f);
+    RequestPublish();
+    return adaptiveTableReport;
+}
 
+AdaptiveTableReport CurveAdjusterProcessor::GetAdaptiveTableReport() const
+{
+    const juce::ScopedLock lock(writerLock);
+    return adaptiveTableReport;
+}
+
+void CurveAdjusterProcessor::DisableLookupTable()
+{
+    const juce::ScopedLock lock(writerLock);
+    lookupTableSize = 0;
+    adaptiveTableMaxError = 0.0f;
+    RequestPublish();
+}
+
+void CurveAdjusterProcessor::SetBackgroundCompilation(bool shouldCompileInBackground)
+{
+    CurveCompiler* drainingCompiler = nullptr;
+    {
+        const juce::ScopedLock lock(writerLock);
+        if (shouldCompileInBackground == (compiler != nullptr))
+        {
+            return;
+        }
+        if (shouldCompileInBackground)
+        {
+            compilerConnectors.reserve(data.GetMaxConnectors());
+            compiler = std::make_unique<juce::SharedResourcePointer<CurveCompiler>>();
+            return;
+        }
+        //the compiler stays installed until it lets go of this, so nothing else writes a snapshot meanwhile
+        isDrainingCompiler = true;
+        drainingCompiler = &compiler->getObject();
+    }
+    //outside writerLock, the compile being waited for takes it
+    drainingCompiler->Remove(*this);
     
-    juce::Path path;
-    path.startNewSubPath(c.startX.load(), c.startY.load());
-    path.quadraticTo(c.controlX.load(), c.controlY.load(), c.endX.load(), c.endY.load());
+    std::unique_ptr<juce::SharedResourcePointer<CurveCompiler>> previousCompiler;
+    {
+        const juce::ScopedLock lock(writerLock);
+        isDrainingCompiler = false;
+        previousCompiler = std::move(compiler);
+        //whatever was still queued, or edited while draining, is published here instead
+        PublishSnapshot();
+    }
+}
 
-    juce::PathFlatteningIterator flatPath {path};
-    juce::Line<float> verticalLineAtX {in_X, 0.0f, in_X, 1.0f};
-    while (flatPath.next())
+bool CurveAdjusterProcessor::IsCompilationPending() const
+{
+    const juce::ScopedLock lock(writerLock);
+    return isDrainingCompiler || (compiler != nullptr && (*compiler)->IsPending(*this));
+}
+
+void CurveAdjusterProcessor::SetTableSharing(bool shouldShareTables)
+{
+    const juce::ScopedLock lock(writerLock);
+    if (shouldShareTables == tableSharing)
+    {
+        return;
+    }
+    if (tableCache == nullptr)
     {
-        if (in_X >= flatPath.x1 && in_X <= flatPath.x2)
+        tableCache = std::make_unique<juce::SharedResourcePointer<CompiledCurveCache>>();
+    }
+    tableSharing = shouldShareTables;
+    //the tables move between the snapshots and the cache, so every buffer is rebuilt in full
+    pendingRanges.fill(DirtyRange::All());
+    RequestPublish();
+}
+
+bool CurveAdjusterProcessor::IsLookupTableEnabled() const
+{
+    const juce::ScopedLock lock(writerLock);
+    return lookupTableSize != 0 || adaptiveTableMaxError > 0.0f;
+}
+
+LookupTableReport CurveAdjusterProcessor::MeasureLookupTable(size_t numPoints, LookupTableFormat format) const
+{
+    const juce::ScopedLock lock(writerLock);
+    
+    CurveSnapshot snapshot(data.GetMaxConnectors());
+    BuildSegments(snapshot, connectorPoints, generation.load(std::memory_order_relaxed), DirtyRange::All());
+    numPoints = std::max(numPoints, CurveLookupTable::minNumPoints);
+    snapshot.UpdateLookupTable(numPoints, format);
+    
+    LookupTableReport report;
+    report.numPoints = numPoints;
+    report.bytesPerTable = format == LookupTableFormat::fixedPoint16 ? numPoints * sizeof(uint16_t) : numPoints * sizeof(float);
+    //the snapshots the audio thread holds (two while crossfading, one otherwise) plus the two in flight
+    const auto numSnapshots = crossfadeLength.load(std::memory_order_relaxed) > 0 ? snapshots.numBuffers : snapshots.numBuffers - 1;
+    report.bytesPerProcessor = report.bytesPerTable * numSnapshots;
+    
+    //several probes per table interval so the worst case between table points is found
+    const auto numProbes = (numPoints - 1) * 16 + 1;
+    SegmentCursor tableCursor;
+    SegmentCursor segmentCursor;
+    double errorSum = 0.0;
+    for (size_t i = 0; i < numProbes; ++i)
+    {
+        const auto x = static_cast<float>(i) / static_cast<float>(numProbes - 1);
+        const auto error = std::abs(snapshot.GetY_AtX(x, tableCursor) - snapshot.GetY_FromSegments(x, segmentCursor));
+        report.maxError = std::max(report.maxError, error);
+        errorSum += error;
+    }
+    report.meanError = static_cast<float>(errorSum / static_cast<double>(numProbes));
+    return report;
+}
+
+juce::String CurveAdjusterProcessor::ExportAsCppHeader(const juce::String& variableName) const
+{
+    //written so the compiler reads back exactly the floats the curve has now
+    auto toLiteral = [](float v)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", static_cast<double>(v));
+        juce::String literal(buffer);
+        if (! literal.containsAnyOf(".en"))
         {
-            juce::Line<float> pathLine {flatPath.x1, flatPath.y1, flatPath.x2, flatPath.y2};
-            return pathLine.getIntersection(verticalLineAtX).y;
+            literal << ".0";
         }
+        return literal + "f";
+    };
+    
+    auto toTypeName = [](SegmentType type) -> const char*
+    {
+        switch (type)
+        {
+            case SegmentType::linear:        return "linear";
+            case SegmentType::hold:          return "hold";
+            case SegmentType::quadratic:     return "quadratic";
+            case SegmentType::monotoneCubic: return "monotoneCubic";
+            case SegmentType::automatic:
+            default:                         return "automatic";
+        }
+    };
+    
+    auto identifier = variableName.retainCharacters("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_");
+    if (identifier.isEmpty() || juce::CharacterFunctions::isDigit(identifier[0]))
+    {
+        identifier = "_" + identifier;
     }
     
+    const juce::ScopedLock lock(writerLock);
+    if (connectorPoints.empty())
+    {
+        jassertfalse; //there has to be a connector at the end, a CurveDefinition can't be empty!
+        return {};
+    }
+    
+    juce::String header;
+    header << "//exported from the curve adjuster \"" << name.toString() << "\"\n\n"
+           << "#pragma once\n"
+           << "#include <sos_curve_adjuster/sos_curve_adjuster.h>\n\n"
+           << "inline constexpr CurveAdjuster::CurveDefinition<" << static_cast<int>(connectorPoints.size()) << "> " << identifier << "\n"
+           << "{{\n";
+    for (const auto& c : connectorPoints)
+    {
+        header << "    {" << toLiteral(c.start.x) << ", " << toLiteral(c.start.y) << ", "
+               << toLiteral(c.control.x) << ", " << toLiteral(c.control.y) << ", "
+               << toLiteral(c.end.x) << ", " << toLiteral(c.end.y);
+        if (c.type != SegmentType::automatic)
+        {
+            header << ", CurveAdjuster::SegmentType::" << toTypeName(c.type);
+        }
+        header << "},\n";
+    }
+    header << "}};\n\n"
+           << "inline constexpr CurveAdjuster::BakedCurve<" << static_cast<int>(connectorPoints.size()) << "> " << identifier << "Baked {" << identifier << "};\n";
+    return header;
+}
 
+void CurveAdjusterProcessor::BuildSegments(CurveSnapshot& snapshot, const std::vector<ConnectorPoints>& points, uint64_t pointsGeneration, const DirtyRange& dirty)
+{
+    const auto numSegments = points.size();
+    auto getConnector = [&points](size_t i) { return points[i].ToDefinition(); };
+    for (auto i = dirty.firstSegment; i < std::min(dirty.endSegment, numSegments); ++i)
+    {
+        snapshot.segments[i] = SegmentBuilder::BuildSegment(getConnector, i, numSegments);
+    }
+    jassert(points.empty() || juce::approximatelyEqual(points.back().end.x, 1.0f)); //there has to be a connector at the end!
+    snapshot.numSegments = numSegments;
+    snapshot.generation = pointsGeneration;
+    snapshot.UpdateSegmentSummaries(dirty.firstSegment);
+}
 
-    jassertfalse; //should have found something!
-    return 0.0f;
-//    float t = (start.x - control.x + SquareRootApproximation::ApproximateSquareRoot(in_X * start.x + in_X * end.x - 2.0f * in_X * control.x + juce::square(control.x) - start.x * end.x)) / (start.x - 2 * control.x + end.x);
-//    pointType targetLineStart
-//    {(1.0f - t) * start.x + t * control.x,
-//        (1.0f - t) * start.y + t * control.y};
-//    pointType targetLineEnd
-//    {(1.0f - t) * control.x + t * end.x,
-//        (1.0f - t) * control.y + t * end.y};
-//    pointType target
-//    {(1.0f - t) * targetLineStart.x + t * targetLineEnd.x,
-//        (1.0f - t) * targetLineStart.y + t * targetLineEnd.y};
-//
-//    return target.y;
+AdaptiveTableReport CurveAdjusterProcessor::CompileSnapshot(CurveSnapshot& snapshot, const std::vector<ConnectorPoints>& points, uint64_t pointsGeneration,
+                                                            const DirtyRange& dirty, size_t tableSize, LookupTableFormat tableFormat, float tableMaxError,
+                                                            CompiledCurveCache* cache, CompiledCurveCache::Reference& bufferTables)
+{
+    BuildSegments(snapshot, points, pointsGeneration, dirty);
+    if (cache != nullptr && (tableSize != 0 || tableMaxError > 0.0f))
+    {
+        //the cache picks up from the entry this buffer held, which matches its previous curve
+        bufferTables = cache->Intern(points, tableSize, tableFormat, tableMaxError, bufferTables, dirty);
+        snapshot.sharedTables = bufferTables.Get();
+        snapshot.UpdateLookupTable(0, tableFormat);
+        snapshot.UpdateAdaptiveTable(0.0f);
+        return bufferTables.GetAdaptiveTableReport();
+    }
+    //released here, off the audio thread, and freed by whichever instance interns next
+    snapshot.sharedTables = nullptr;
+    bufferTables.Release();
+    snapshot.UpdateLookupTable(tableSize, tableFormat, dirty);
+    //knots move with the whole curve, so the adaptive table is always rebuilt in full
+    return snapshot.UpdateAdaptiveTable(tableMaxError);
+}
+
+void CurveAdjusterProcessor::PublishSnapshot(const float* bakedTable, size_t bakedTableSize)
+{
+    //the write buffer is never the one the audio thread is reading. it holds an older curve,
+    //so it's brought up to date with every edit made since it was last written
+    ReclaimParkedSnapshots();
+    auto& snapshot = snapshots.GetWriteBuffer();
+    const auto writeIndex = snapshots.GetWriteIndex();
+    auto& pending = pendingRanges[writeIndex];
+    const auto currentGeneration = generation.load(std::memory_order_relaxed);
+    if (bakedTable != nullptr)
+    {
+        adaptiveTableReport = CompileSnapshot(snapshot, connectorPoints, currentGeneration, pending, 0, lookupTableFormat, 0.0f, nullptr, sharedTables[writeIndex]);
+        snapshot.lookupTable.Assign(bakedTable, bakedTableSize);
+    }
+    else
+    {
+        adaptiveTableReport = CompileSnapshot(snapshot, connectorPoints, currentGeneration, pending, lookupTableSize, lookupTableFormat, adaptiveTableMaxError,
+                                              GetTableCache(), sharedTables[writeIndex]);
+    }
+    maxSlope.store(snapshot.maxSlope, std::memory_order_relaxed);
+    pending = {};
+    
+    snapshots.Publish();
+}
+
+void CurveAdjusterProcessor::ReclaimParkedSnapshots()
+{
+    snapshots.ReclaimParked([this](CurveSnapshot& parked, size_t index)
+    {
+        parked.UpdateLookupTable(0, lookupTableFormat);
+        parked.UpdateAdaptiveTable(0.0f);
+        parked.sharedTables = nullptr;
+        sharedTables[index].Release();
+        //its segments are kept, but it's rebuilt in full when it comes back
+        pendingRanges[index] = DirtyRange::All();
+    });
+}
+
+CompiledCurveCache* CurveAdjusterProcessor::GetTableCache() const
+{
+    return tableSharing ? &tableCache->getObject() : nullptr;
+}
+
+void CurveAdjusterProcessor::RequestPublish()
+{
+    if (isDrainingCompiler)
+    {
+        return; //left in pendingRanges for SetBackgroundCompilation to publish
+    }
+    if (compiler == nullptr)
+    {
+        PublishSnapshot();
+        return;
+    }
+    (*compiler)->Request(*this);
+}
+
+void CurveAdjusterProcessor::CompileInBackground()
+{
+    //the curve and settings are copied under the lock, the build itself runs without it so edits never wait
+    DirtyRange dirty;
+    uint64_t compileGeneration {0};
+    size_t tableSize {0};
+    LookupTableFormat tableFormat {LookupTableFormat::floatingPoint};
+    float tableMaxError {0.0f};
+    CompiledCurveCache* cache {nullptr};
+    {
+        const juce::ScopedLock lock(writerLock);
+        compilerConnectors = connectorPoints;
+        compileGeneration = generation.load(std::memory_order_relaxed);
+        tableSize = lookupTableSize;
+        tableFormat = lookupTableFormat;
+        tableMaxError = adaptiveTableMaxError;
+        cache = GetTableCache();
+        ReclaimParkedSnapshots();
+        //an edit from now on lands in this buffer's pending range again, for the next compile
+        dirty = std::exchange(pendingRanges[snapshots.GetWriteIndex()], DirtyRange());
+    }
+    
+    auto& snapshot = snapshots.GetWriteBuffer();
+    const auto report = CompileSnapshot(snapshot, compilerConnectors, compileGeneration, dirty, tableSize, tableFormat, tableMaxError,
+                                        cache, sharedTables[snapshots.GetWriteIndex()]);
+    {
+        const juce::ScopedLock lock(writerLock);
+        adaptiveTableReport = report;
+    }
+    maxSlope.store(snapshot.maxSlope, std::memory_order_relaxed);
+    snapshots.Publish();
 }
 
 }
@@ -11,23 +11,68 @@
 #pragma once
 
 #include "ICurveAdjusterProcessor.h"
+#include "BakedCurve.h"
+#include "CompiledCurveCache.h"
+#include "CurveCompiler.h"
 #include "SmoothedValueManager.h"
+#include "CurveSnapshot.h"
+#include "CurveStateSerialisation.h"
+#include "SnapshotExchange.h"
+#include "VoiceSmoothers.h"
+#include <juce_dsp/juce_dsp.h>
 #include "DebugHelperFunctions.h"
 
 
 
 namespace CurveAdjuster
 {
+    //what a lookup table would cost and how far it strays from the solved curve, see MeasureLookupTable
+    struct LookupTableReport
+    {
+        size_t numPoints {0};
+        size_t bytesPerTable {0};
+        size_t bytesPerProcessor {0}; //every snapshot the processor keeps holds its own table, one fewer of them without a crossfade
+        float maxError {0.0f};
+        float meanError {0.0f};
+    };
+
+    enum class WaveshaperOversampling
+    {
+        none,
+        times2,
+        times4
+    };
 
     class CurveAdjusterProcessor : public ICurveAdjusterProcessor
     {
     public:
+        //told after every new curve, on the thread that set it (not the audio thread)
+        class Listener
+        {
+        public:
+            virtual ~Listener() = default;
+            virtual void CurveChanged(CurveAdjusterProcessor& processor) = 0;
+        };
 
-        CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints);
+        //maxConnectors is the most the curve (and the editor) can ever have, one less than the number of handles
+        CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints,
+                               size_t maxConnectors = CurveAdjusterProcessorData::defaultMaxConnectors);
         CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement); //default linear ramp up
+        
+        /*factory curve from ExportAsCppHeader: the audio thread starts on the compiler's table, nothing is
+         sampled at startup. starts in lookup table mode as if EnableLookupTable(numPoints) had been called,
+         so edits resample a table of the same size. DisableLookupTable to solve the segments instead*/
+        template <size_t numConnectors, size_t numPoints>
+        CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, const BakedCurve<numConnectors, numPoints>& bakedCurve)
+        : CurveAdjusterProcessor(n, initVal, smoothingIncrement, ToConnectorPoints(bakedCurve.GetDefinition()),
+                                 std::max(numConnectors, CurveAdjusterProcessorData::defaultMaxConnectors), bakedCurve.GetTable().data(), numPoints)
+        {
+        }
+        
         ~CurveAdjusterProcessor() override;
 
         size_t GetNumConnectors() override;
+        uint64_t GetGeneration() const override;
 
         void SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo) override;
         void LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree) override;
@@ -35,11 +80,109 @@ namespace CurveAdjuster
 
 
         float GetTranslatedOutput(float x);
+        
+        /*GetTranslatedOutput plus dy/dx from the same segment solve, and the precomputed steepest slope
+         of that segment, e.g. to pick smoothing or oversampling without probing the curve.
+         solves the segments even in lookup table mode*/
+        CurveValueAndSlope GetTranslatedOutputWithSlope(float x);
+        
+        //steepest |dy/dx| of the whole current curve, updated with every new curve. any thread
+        float GetMaxSlope() const;
+        
+        /*maps a whole buffer at once and publishes inputX once per block instead of per sample.
+         inputs are clamped to 0-1, in == out is allowed*/
+        void ProcessBlock(const float* in, float* out, int numSamples);
+        //maps every channel in place
+        void ProcessBlock(juce::dsp::AudioBlock<float>& block);
+        
+        /*smooths towards target with smoothedVal and maps the result into out.
+         while no ramp is running the curve is evaluated once for the whole block*/
+        void ProcessSmoothedBlock(float target, float* out, int numSamples);
+        
+        /*the input that GetTranslatedOutput maps to y, solved per segment (no audio thread state is touched).
+         where several inputs give y (a curve that turns back) the smallest is returned.
+         where none do, the input whose output comes closest to y, the smallest of those on a tie.
+         uses the segments rather than the lookup table, and locks like SetConnectors, so message thread only*/
+        float GetInputForOutput(float y) const;
+        
+        /*polyphonic: smooths and maps every voice for a block against one shared snapshot.
+         each sample evaluates the playing voices, packed together, in one vectorized call.
+         voiceOutputs[v] receives numSamples values, pass nullptr for voices that aren't playing (they are only smoothed)*/
+        void ProcessVoices(VoiceSmoothers& voices, float* const* voiceOutputs, int numSamples);
+        
+        /*waveshaper mode: the curve as a bipolar transfer function, audio x in -1 to 1 maps to curve input
+         (x + 1) / 2 and the output back to 2y - 1. antialiased with first order ADAA: each output is the
+         mean of the curve between consecutive inputs, taken from the segments' closed form integrals.
+         ADAA adds half a sample of delay, oversampling (polyphase IIR halfband) adds its own, see GetWaveshaperLatency.
+         prepare allocates, call it from prepareToPlay*/
+        void PrepareWaveshaper(const juce::dsp::ProcessSpec& spec, WaveshaperOversampling oversampling = WaveshaperOversampling::none);
+        void ResetWaveshaper();
+        //every channel in place. the block may not hold more channels or samples than were prepared
+        void ProcessWaveshaper(juce::dsp::AudioBlock<float>& block);
+        float GetWaveshaperLatency() const;
+        
+        /*when the curve changes, the output crossfades from the old shape to the new one over this long
+         instead of jumping. costs a second evaluation per sample only while fading. 0 (default) is off.
+         a change made while a fade is running is picked up once that fade has finished*/
+        void SetShapeCrossfadeLength(double seconds, double sampleRate);
+        
+        /*replaces the whole curve. data is updated and the audio thread is handed a complete new
+         snapshot with one atomic exchange, so it never evaluates a half written curve.
+         not for the audio thread: it builds the snapshot (and lookup table) on the calling thread.
+         only the connectors that differ from the current curve are rebuilt, and only the inputs they cover
+         are resampled into the lookup table. setting the curve it already has does nothing*/
+        void SetConnectors(const std::vector<ConnectorPoints>& newConnectorPoints);
+        std::vector<ConnectorPoints> GetConnectors() const;
+        
+        void AddListener(Listener* listener);
+        void RemoveListener(Listener* listener);
+        
+        //a copy of the current curve to evaluate off the audio thread, stamped with its generation. allocates
+        CurveSnapshot GetCurveCopy() const;
+        
+        /*opt in: GetTranslatedOutput interpolates a table of numPoints samples instead of solving segments.
+         the table is rebuilt with every new curve. safe while processing, but not from the audio thread.
+         fixedPoint16 halves the memory, which adds up with many instances, for slightly more error*/
+        void EnableLookupTable(size_t numPoints, LookupTableFormat format = LookupTableFormat::floatingPoint);
+        /*opt in, instead of EnableLookupTable: a table with knots placed where the curve bends, built to stay
+         within maxError of the segments. fewer points than an even table on gentle curves, more precise on
+         steep ones. rebuilt with every new curve, returns what the current curve cost (see GetAdaptiveTableReport)*/
+        AdaptiveTableReport EnableAdaptiveLookupTable(float maxError);
+        AdaptiveTableReport GetAdaptiveTableReport() const;
+        //turns off either kind of table
+        void DisableLookupTable();
+        bool IsLookupTableEnabled() const;
+        
+        /*builds a table for the current curve without enabling it and compares it against the segments,
+         so the size/accuracy trade off can be checked before choosing. allocates, message thread only*/
+        LookupTableReport MeasureLookupTable(size_t numPoints, LookupTableFormat format) const;
+        
+        /*opt in: new curves and table settings are built on the shared CurveCompiler thread instead of the
+         thread that set them, so a drag never waits for a big table. the audio thread keeps the previous
+         curve until the build is published. edits made while a build waits are folded into it.
+         with this on, the adaptive table report from EnableAdaptiveLookupTable arrives with the build,
+         read it later with GetAdaptiveTableReport. message thread*/
+        void SetBackgroundCompilation(bool shouldCompileInBackground);
+        //true while a curve is set but not yet handed to the audio thread, including while it's being built
+        bool IsCompilationPending() const;
+        
+        /*opt in: lookup tables come from the shared CompiledCurveCache, so every instance holding an identical
+         curve with the same table settings uses one table, compiled once. worth it with many instances of few
+         curves (voices, factory presets). the audio thread only follows a pointer, it never touches the cache.
+         give the cache a directory (CompiledCurveCache::SetDiskCacheDirectory) to keep tables between sessions.
+         message thread*/
+        void SetTableSharing(bool shouldShareTables);
+        
+        /*the current curve as a header holding a constexpr CurveDefinition named variableName,
+         plus a BakedCurve of it named variableName + "Baked", for shipping it as a factory curve.
+         empty for a curve with no connectors, which has nothing to bake*/
+        juce::String ExportAsCppHeader(const juce::String& variableName) const;
 
         juce::Atomic<float> inputX {0.0f};
         
         std::atomic<bool> ReadyForGuiInit{ false } ;
         
+        //mirror of the curve for the editor and SaveState. write through SetConnectors, the audio thread never reads this
         CurveAdjusterProcessorData data;
         
         SmoothedValueManager smoothedVal;
@@ -47,16 +190,90 @@ namespace CurveAdjuster
     protected:
         void SetState(juce::ValueTree& curveAdjusterTree) override;
         void RemoveThisCurveAdjusterTreeFromAPVTS(juce::ValueTree& treeapvtsTree, juce::ValueTree& curveAdjusterTree) override;
-        float GetY_AtX(const AtomicConnector& c, float in_X);
-        
 
     private:
+        CurveAdjusterProcessor(std::string n, float initVal, double smoothingIncrement, std::vector<ConnectorPoints> _connnectorPoints,
+                               size_t maxConnectors, const float* bakedTable, size_t bakedTableSize);
+        
+        template <size_t numConnectors>
+        static std::vector<ConnectorPoints> ToConnectorPoints(const CurveDefinition<numConnectors>& definition)
+        {
+            std::vector<ConnectorPoints> points;
+            for (const auto& c : definition)
+            {
+                points.push_back({{c.startX, c.startY}, {c.controlX, c.controlY}, {c.endX, c.endY}, c.type});
+            }
+            return points;
+        }
         
         bool defaultDataAdded{ false }; 
+        
+        //writers can be the editor and the host restoring state, the audio thread never takes this
+        juce::CriticalSection writerLock;
+        std::vector<ConnectorPoints> connectorPoints; //the current curve, guarded by writerLock
+        std::atomic<uint64_t> generation {0};         //of connectorPoints, written under writerLock
+        juce::ListenerList<Listener, juce::Array<Listener*, juce::CriticalSection>> listeners;
+        size_t lookupTableSize {0};                   //0 when lookup table mode is off, guarded by writerLock
+        LookupTableFormat lookupTableFormat {LookupTableFormat::floatingPoint}; //guarded by writerLock
+        float adaptiveTableMaxError {0.0f};           //0 when the adaptive table is off, guarded by writerLock
+        AdaptiveTableReport adaptiveTableReport;      //of the last published curve, guarded by writerLock
+        
+        //set while background compilation is on, guarded by writerLock. the compiler is then the only snapshot writer
+        std::unique_ptr<juce::SharedResourcePointer<CurveCompiler>> compiler;
+        bool isDrainingCompiler {false}; //guarded by writerLock, set while turning background compilation off
+        std::vector<ConnectorPoints> compilerConnectors; //the compiler thread's copy, capacity reserved up front
+        
+        //created the first time sharing is turned on and kept until destruction, so a compile in flight can't lose it
+        std::unique_ptr<juce::SharedResourcePointer<CompiledCurveCache>> tableCache;
+        bool tableSharing {false}; //guarded by writerLock
+        
+        //the audio thread holds the newest snapshot and the one before it to crossfade from
+        SnapshotExchange<CurveSnapshot, 2> snapshots;
+        //per snapshot buffer, the edits it's missing since it was last written. guarded by writerLock
+        std::array<DirtyRange, SnapshotExchange<CurveSnapshot, 2>::numBuffers> pendingRanges;
+        //per snapshot buffer, the cache entry its sharedTables points at. written only with the buffer
+        std::array<CompiledCurveCache::Reference, SnapshotExchange<CurveSnapshot, 2>::numBuffers> sharedTables;
+        SegmentCursor audioThreadCursor;
+        SegmentCursor previousSnapshotCursor;
+        
+        std::atomic<float> maxSlope {0.0f};
+        std::atomic<int> crossfadeLength {0};
+        int activeCrossfadeLength {0}; //audio thread only
+        int crossfadeRemaining {0};    //audio thread only
+        static constexpr int crossfadeChunkSize {64};
+        
+        bool StoreConnectors(const std::vector<ConnectorPoints>& newConnectorPoints); //caller holds writerLock, false when nothing changed
+        //caller holds writerLock. a baked table replaces this snapshot's table instead of sampling one
+        void PublishSnapshot(const float* bakedTable = nullptr, size_t bakedTableSize = 0);
+        //caller holds writerLock. publishes now, or queues on the compiler when background compilation is on
+        void RequestPublish();
+        CompiledCurveCache* GetTableCache() const; //caller holds writerLock, nullptr when sharing is off
+        void ReclaimParkedSnapshots(); //caller holds writerLock and is the thread writing snapshots
+        
+        friend class CurveCompiler;
+        void CompileInBackground(); //compiler thread
+        
+        /*brings snapshot up to date with points, from the segments and inputs in dirty. touches no members.
+         with a cache, the tables come from there and bufferTables is swapped for the new curve's entry*/
+        static AdaptiveTableReport CompileSnapshot(CurveSnapshot& snapshot, const std::vector<ConnectorPoints>& points, uint64_t pointsGeneration,
+                                                   const DirtyRange& dirty, size_t tableSize, LookupTableFormat tableFormat, float tableMaxError,
+                                                   CompiledCurveCache* cache, CompiledCurveCache::Reference& bufferTables);
+        static void BuildSegments(CurveSnapshot& snapshot, const std::vector<ConnectorPoints>& points, uint64_t pointsGeneration, const DirtyRange& dirty);
+        const CurveSnapshot& AcquireSnapshot();
+        float GetCrossfadeGain(int samplesAhead) const;
+        void ProcessWithCrossfade(const CurveSnapshot& snapshot, const float* in, float* out, int numSamples);
+        
+        std::unique_ptr<juce::dsp::Oversampling<float>> waveshaperOversampling;
+        std::vector<float> waveshaperPreviousInputs; //per channel, at the oversampled rate
+        SegmentCursor waveshaperCursor;
+        static constexpr double antiderivativeTolerance {1.0e-5};
+        
+        /*shapes samples in place. previousInput is the last input before them and is updated.
+         samplesPerFadeStep > 1 when oversampled, so the fade keeps its length in host samples*/
+        void ShapeWithCrossfade(const CurveSnapshot& snapshot, float* samples, int numSamples, float& previousInput, int samplesPerFadeStep);
+        void ShapeAntialiased(const CurveSnapshot& snapshot, const float* in, float* out, int numSamples, float previousInput);
 
         const juce::Identifier name;
-        const juce::Identifier connectors_ID {"control_coordinates"};
-        const juce::Identifier value_string_as_ID {"value"};
         
         //juce::Graphics g; //for path
         
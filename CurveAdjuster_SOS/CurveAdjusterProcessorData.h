@@ -9,6 +9,8 @@
 */
 #pragma once
 #include "CurveAdjusterPointTypes.h"
+#include "DirtyRange.h"
+#include "SegmentBuilder.h"
 
 namespace CurveAdjuster
 {
@@ -16,126 +18,172 @@ namespace CurveAdjuster
     struct ConnectorPoints
     {
         pointType start, control, end;
+        SegmentType type {SegmentType::automatic};
+        
+        ConnectorDefinition ToDefinition() const
+        {
+            return {start.x, start.y, control.x, control.y, end.x, end.y, type};
+        }
+        
+        bool operator== (const ConnectorPoints& other) const
+        {
+            return start == other.start && control == other.control && end == other.end && type == other.type;
+        }
+        
+        bool operator!= (const ConnectorPoints& other) const
+        {
+            return ! operator==(other);
+        }
     };
+    
+    /*what changed from before to after. connectors that only moved to a different index (a handle added
+     or removed before them) need their segment rewritten but cover the same inputs, so they stay out of
+     the input range. a monotone cubic next to a change takes its tangents from it, so it's dirty too*/
+    inline DirtyRange FindDirtyRange(const std::vector<ConnectorPoints>& before, const std::vector<ConnectorPoints>& after)
+    {
+        size_t first = 0;
+        while (first < before.size() && first < after.size() && before[first] == after[first])
+        {
+            ++first;
+        }
+        auto endBefore = before.size();
+        auto endAfter = after.size();
+        while (endBefore > first && endAfter > first && before[endBefore - 1] == after[endAfter - 1])
+        {
+            --endBefore;
+            --endAfter;
+        }
+        if (first == endBefore && first == endAfter)
+        {
+            return {};
+        }
+        
+        //neighbouring cubics, in the new curve
+        if (first > 0 && after[first - 1].type == SegmentType::monotoneCubic)
+        {
+            --first;
+        }
+        if (endAfter < after.size() && after[endAfter].type == SegmentType::monotoneCubic)
+        {
+            ++endAfter;
+        }
+        
+        DirtyRange range;
+        range.firstSegment = first;
+        range.endSegment = before.size() == after.size() ? std::max(endBefore, endAfter) : std::max(before.size(), after.size());
+        for (auto i = first; i < endBefore; ++i)
+        {
+            range.AddInputs(before[i].start.x, before[i].end.x);
+        }
+        for (auto i = first; i < endAfter; ++i)
+        {
+            range.AddInputs(after[i].start.x, after[i].end.x);
+        }
+        return range;
+    }
 
+    /*one connector's fields inside CurveAdjusterProcessorData, e.g. data[i].endX.load().
+     a handle to the storage, not a copy, so keep it no longer than the data*/
     struct AtomicConnector
     {
-        std::atomic<float> startX {-1.0f};
-        std::atomic<float> startY {-1.0f};
-        std::atomic<float> controlX {-1.0f};
-        std::atomic<float> controlY {-1.0f};
-        std::atomic<float> endX {-1.0f};
-        std::atomic<float> endY {-1.0f};
-        
+        std::atomic<float>& startX;
+        std::atomic<float>& startY;
+        std::atomic<float>& controlX;
+        std::atomic<float>& controlY;
+        std::atomic<float>& endX;
+        std::atomic<float>& endY;
+        std::atomic<int>& type;
     };
     
-    struct CurveAdjusterProcessorData
+    /*the curve for the editor and save state, one column per field (all the startX, then all the startY...)
+     so a scan like "which connector ends at x = 1" reads consecutive values. each column starts on its
+     own cache line and the capacity is fixed at construction. unused connectors hold -1*/
+    class CurveAdjusterProcessorData
     {
-        AtomicConnector connector0;
-        AtomicConnector connector1;
-        AtomicConnector connector2;
-        AtomicConnector connector3;
-        AtomicConnector connector4;
-        AtomicConnector connector5;
-        AtomicConnector connector6;
-        AtomicConnector connector7;
-        AtomicConnector connector8;
-        AtomicConnector connector9;
-        AtomicConnector connector10;
-        AtomicConnector connector11;
-        AtomicConnector connector12;
-        AtomicConnector connector13;
-        AtomicConnector connector14;
-        AtomicConnector connector15;
-        AtomicConnector connector16;
-        AtomicConnector connector17;
-        AtomicConnector connector18;
-        AtomicConnector connector19;
-        AtomicConnector connector20;
-        AtomicConnector connector21;
-        AtomicConnector connector22;
-        AtomicConnector connector23;
-        AtomicConnector connector24;
-        AtomicConnector connector25;
-        AtomicConnector connector26;
-        AtomicConnector connector27;
-        AtomicConnector connector28;
-        AtomicConnector connector29;
+    public:
+        static constexpr size_t defaultMaxConnectors {30}; //31 handles
         
-        const std::atomic<size_t> maxConnectors{30};
-
-        AtomicConnector& operator[](size_t index)
+        explicit CurveAdjusterProcessorData(size_t _maxConnectors = defaultMaxConnectors)
+        : maxConnectors(std::max(_maxConnectors, static_cast<size_t>(1))),
+          columnStride(RoundUpToLine(maxConnectors)),
+          floatLines(numFloatColumns * columnStride / valuesPerLine),
+          typeLines(columnStride / valuesPerLine)
         {
-            jassert(index < maxConnectors.load()); //index is out of range!
-            
-            switch(index)
+            //atomics in a vector start out uninitialised
+            for (auto& line : floatLines)
+            {
+                for (auto& v : line.values)
+                {
+                    v.store(-1.0f, std::memory_order_relaxed);
+                }
+            }
+            for (auto& line : typeLines)
             {
-                case 0:
-                    return connector0;
-                case 1:
-                    return connector1;
-                case 2:
-                    return connector2;
-                case 3:
-                    return connector3;
-                case 4:
-                    return connector4;
-                case 5:
-                    return connector5;
-                case 6:
-                    return connector6;
-                case 7:
-                    return connector7;
-                case 8:
-                    return connector8;
-                case 9:
-                    return connector9;
-                case 10:
-                    return connector10;
-                case 11:
-                    return connector11;
-                case 12:
-                    return connector12;
-                case 13:
-                    return connector13;
-                case 14:
-                    return connector14;
-                case 15:
-                    return connector15;
-                case 16:
-                    return connector16;
-                case 17:
-                    return connector17;
-                case 18:
-                    return connector18;
-                case 19:
-                    return connector19;
-                case 20:
-                    return connector20;
-                case 21:
-                    return connector21;
-                case 22:
-                    return connector22;
-                case 23:
-                    return connector23;
-                case 24:
-                    return connector24;
-                case 25:
-                    return connector25;
-                case 26:
-                    return connector26;
-                case 27:
-                    return connector27;
-                case 28:
-                    return connector28;
+                for (auto& v : line.values)
+                {
+                    v.store(static_cast<int>(SegmentType::automatic), std::memory_order_relaxed);
+                }
             }
-            //must be last connector. this is asserted at beginning of function
-            return connector29;
+        }
+        
+        size_t GetMaxConnectors() const
+        {
+            return maxConnectors;
+        }
+
+        //how many of the rows hold the curve, stored after the rows themselves
+        size_t GetNumConnectors() const
+        {
+            return numConnectors.load(std::memory_order_acquire);
+        }
+
+        void SetNumConnectors(size_t n)
+        {
+            jassert(n <= maxConnectors);
+            numConnectors.store(std::min(n, maxConnectors), std::memory_order_release);
         }
 
-        AtomicConnector& operator[](int index)
+        AtomicConnector operator[](size_t index)
+        {
+            jassert(index < maxConnectors); //index is out of range!
+            index = std::min(index, maxConnectors - 1);
+            return {GetFloat(0, index), GetFloat(1, index), GetFloat(2, index),
+                    GetFloat(3, index), GetFloat(4, index), GetFloat(5, index),
+                    typeLines[index / valuesPerLine].values[index % valuesPerLine]};
+        }
+
+        AtomicConnector operator[](int index)
         {
             return operator[](static_cast<size_t>(index));
         }
+        
+    private:
+        static constexpr size_t cacheLineSize {64};
+        static constexpr size_t valuesPerLine {cacheLineSize / sizeof(float)};
+        static constexpr size_t numFloatColumns {6};
+        static_assert(sizeof(std::atomic<float>) == sizeof(float) && sizeof(std::atomic<int>) == sizeof(float), "values are packed by the line");
+        
+        template <typename T>
+        struct alignas(cacheLineSize) CacheLine
+        {
+            std::atomic<T> values[valuesPerLine];
+        };
+        
+        static size_t RoundUpToLine(size_t n)
+        {
+            return (n + valuesPerLine - 1) / valuesPerLine * valuesPerLine;
+        }
+        
+        std::atomic<float>& GetFloat(size_t column, size_t index)
+        {
+            const auto position = column * columnStride + index;
+            return floatLines[position / valuesPerLine].values[position % valuesPerLine];
+        }
+        
+        const size_t maxConnectors;
+        const size_t columnStride; //maxConnectors rounded up to whole cache lines
+        std::vector<CacheLine<float>> floatLines;
+        std::vector<CacheLine<int>> typeLines;
+        std::atomic<size_t> numConnectors {0};
     };
 }
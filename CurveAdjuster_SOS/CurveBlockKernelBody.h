@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    CurveBlockKernelBody.h
+    Created: 17 Oct 2026 12:37:30pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+//no include guard on purpose: CurveBlockKernels.h includes this once per instruction set,
+//inside a namespace that first defines a matching Ops struct
+
+static_assert(sizeof(QuadraticSegment) % sizeof(float) == 0, "segments are gathered as arrays of floats");
+
+//without solveQuadratics every segment has x linear in t (see QuadraticSegment::IsLinearInX), so the square root is skipped
+template <bool solveQuadratics>
+inline void ProcessSegmentsVector(const QuadraticSegment* segments, size_t numSegments, const float* in, float* out)
+{
+    constexpr int stride = static_cast<int>(sizeof(QuadraticSegment) / sizeof(float));
+    const auto zero = Ops::Set(0.0f);
+    const auto one = Ops::Set(1.0f);
+
+    const auto x = Ops::Min(Ops::Max(Ops::Load(in), zero), one);
+
+    //index of the last segment starting at or before x, without branching per lane
+    auto index = Ops::SetInt(0);
+    for (size_t s = 1; s < numSegments; ++s)
+    {
+        index = Ops::IncrementWhere(index, Ops::LessEqual(Ops::Set(segments[s].startX), x));
+    }
+
+    const auto startX = Ops::Gather(&segments->startX, index, stride);
+    const auto startY = Ops::Gather(&segments->startY, index, stride);
+    const auto ay = Ops::Gather(&segments->ay, index, stride);
+    const auto by = Ops::Gather(&segments->by, index, stride);
+    const auto cy = Ops::Gather(&segments->cy, index, stride);
+
+    Ops::Float t;
+    if constexpr (solveQuadratics)
+    {
+        const auto endX = Ops::Gather(&segments->endX, index, stride);
+        const auto ax = Ops::Gather(&segments->ax, index, stride);
+        const auto bx = Ops::Gather(&segments->bx, index, stride);
+        const auto bxFromEnd = Ops::Gather(&segments->bxFromEnd, index, stride);
+
+        //same solve as QuadraticSegment::GetT_AtX, one lane per sample
+        const auto fromStartX = Ops::Sub(x, startX);
+        const auto fromEndX = Ops::Sub(endX, x);
+        const auto fromStart = Ops::LessEqual(fromStartX, fromEndX);
+        const auto d = Ops::Select(fromStart, fromStartX, fromEndX);
+        const auto a = Ops::Select(fromStart, ax, Ops::Sub(zero, ax));
+        const auto b = Ops::Select(fromStart, bx, bxFromEnd);
+        const auto discriminant = Ops::Max(Ops::Add(Ops::Mul(b, b), Ops::Mul(Ops::Set(4.0f), Ops::Mul(a, d))), zero);
+        const auto denominator = Ops::Max(Ops::Add(b, Ops::Sqrt(discriminant)), Ops::Set(QuadraticSegment::minDenominator));
+        const auto u = Ops::Min(Ops::Max(Ops::Div(Ops::Mul(Ops::Set(2.0f), d), denominator), zero), one);
+        t = Ops::Select(fromStart, u, Ops::Sub(one, u));
+    }
+    else
+    {
+        const auto invWidth = Ops::Gather(&segments->invWidth, index, stride);
+        t = Ops::Min(Ops::Max(Ops::Mul(Ops::Sub(x, startX), invWidth), zero), one);
+    }
+
+    Ops::Store(out, Ops::Add(Ops::Mul(Ops::Add(Ops::Mul(Ops::Add(Ops::Mul(cy, t), ay), t), by), t), startY));
+}
+
+inline void ProcessLookupTableVector(const float* table, size_t numPoints, const float* in, float* out)
+{
+    const auto scale = Ops::Set(static_cast<float>(numPoints - 1));
+    const auto maxIndex = Ops::Set(static_cast<float>(numPoints - 2));
+
+    const auto x = Ops::Min(Ops::Max(Ops::Load(in), Ops::Set(0.0f)), Ops::Set(1.0f));
+    const auto position = Ops::Mul(x, scale);
+    const auto indexAsFloat = Ops::Min(Ops::ToFloat(Ops::ToInt(position)), maxIndex);
+    const auto fraction = Ops::Sub(position, indexAsFloat);
+    const auto index = Ops::ToInt(indexAsFloat);
+
+    const auto lower = Ops::Gather(table, index, 1);
+    const auto upper = Ops::Gather(table + 1, index, 1);
+    Ops::Store(out, Ops::Add(lower, Ops::Mul(fraction, Ops::Sub(upper, lower))));
+}
+
+//the tail is padded with the last input so every call processes a whole vector
+inline void FillTail(const float* in, int numSamples, int start, float* tail)
+{
+    for (int j = 0; j < Ops::width; ++j)
+    {
+        tail[j] = in[std::min(start + j, numSamples - 1)];
+    }
+}
+
+template <bool solveQuadratics>
+inline void ProcessSegments(const QuadraticSegment* segments, size_t numSegments, const float* in, float* out, int numSamples)
+{
+    int i = 0;
+    for (; i + Ops::width <= numSamples; i += Ops::width)
+    {
+        ProcessSegmentsVector<solveQuadratics>(segments, numSegments, in + i, out + i);
+    }
+    if (i < numSamples)
+    {
+        float inTail[Ops::width];
+        float outTail[Ops::width];
+        FillTail(in, numSamples, i, inTail);
+        ProcessSegmentsVector<solveQuadratics>(segments, numSegments, inTail, outTail);
+        std::copy(outTail, outTail + (numSamples - i), out + i);
+    }
+}
+
+inline void ProcessLookupTable(const float* table, size_t numPoints, const float* in, float* out, int numSamples)
+{
+    int i = 0;
+    for (; i + Ops::width <= numSamples; i += Ops::width)
+    {
+        ProcessLookupTableVector(table, numPoints, in + i, out + i);
+    }
+    if (i < numSamples)
+    {
+        float inTail[Ops::width];
+        float outTail[Ops::width];
+        FillTail(in, numSamples, i, inTail);
+        ProcessLookupTableVector(table, numPoints, inTail, outTail);
+        std::copy(outTail, outTail + (numSamples - i), out + i);
+    }
+}
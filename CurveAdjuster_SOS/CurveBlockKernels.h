@@ -0,0 +1,336 @@
+/*
+  ==============================================================================
+
+    CurveBlockKernels.h
+    Created: 17 Oct 2026 12:37:55pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "QuadraticSegment.h"
+#include <algorithm>
+#include <cassert>
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #define SOS_CURVE_KERNELS_X86 1
+ //every x64 cpu has SSE2, a 32 bit build may not have been told it can assume it
+ #if defined (__x86_64__) || defined (_M_X64) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SOS_CURVE_KERNELS_SSE2_BASELINE 1
+ #endif
+ #include <immintrin.h>
+ #if defined (_MSC_VER)
+  #include <intrin.h>
+ #endif
+#elif defined (__aarch64__) || defined (_M_ARM64)
+ #define SOS_CURVE_KERNELS_ARM64 1
+ #include <arm_neon.h>
+#endif
+
+namespace CurveAdjuster
+{
+    /*buffer evaluation of a curve. the instruction set (AVX2 or SSE2 on x86, NEON on arm64)
+     is chosen once at runtime, with a scalar fallback everywhere else (including 32 bit x86 without SSE2).
+     inputs are clamped to 0-1 and in == out is allowed.
+     header only and JUCE free, see CurveKernel.h*/
+    namespace BlockKernels
+    {
+        //segments[0] must start at x = 0, numSegments is the count up to and including the one ending at x = 1
+        inline void ProcessSegments(const QuadraticSegment* segments, size_t numSegments, const float* in, float* out, int numSamples);
+
+        //as above, with the kernel choice made by the caller, e.g. once per snapshot. allLinearInX must be true only when every segment IsLinearInX
+        inline void ProcessSegments(const QuadraticSegment* segments, size_t numSegments, bool allLinearInX, const float* in, float* out, int numSamples);
+
+        //table holds numPoints (>= 2) evenly spaced samples over x = 0 to 1
+        inline void ProcessLookupTable(const float* table, size_t numPoints, const float* in, float* out, int numSamples);
+
+        //for debugging / benchmarking
+        inline const char* GetInstructionSetName();
+    }
+}
+
+//==============================================================================
+namespace CurveAdjuster
+{
+namespace BlockKernels
+{
+
+namespace Scalar
+{
+    struct Ops
+    {
+        using Float = float;
+        using Int = int;
+        using Mask = bool;
+        static constexpr int width = 1;
+
+        static Float Load(const float* p) { return *p; }
+        static void Store(float* p, Float v) { *p = v; }
+        static Float Set(float v) { return v; }
+        static Int SetInt(int v) { return v; }
+        static Float Add(Float a, Float b) { return a + b; }
+        static Float Sub(Float a, Float b) { return a - b; }
+        static Float Mul(Float a, Float b) { return a * b; }
+        static Float Div(Float a, Float b) { return a / b; }
+        static Float Min(Float a, Float b) { return std::min(a, b); }
+        static Float Max(Float a, Float b) { return std::max(a, b); }
+        static Float Sqrt(Float a) { return std::sqrt(a); }
+        static Mask LessEqual(Float a, Float b) { return a <= b; }
+        static Float Select(Mask m, Float a, Float b) { return m ? a : b; }
+        static Int IncrementWhere(Int i, Mask m) { return i + (m ? 1 : 0); }
+        static Int ToInt(Float a) { return static_cast<int>(a); }
+        static Float ToFloat(Int i) { return static_cast<float>(i); }
+        static Float Gather(const float* base, Int i, int stride) { return base[i * stride]; }
+    };
+
+    #include "CurveBlockKernelBody.h"
+}
+
+#if SOS_CURVE_KERNELS_X86
+//on 32 bit builds that don't assume SSE2 it's checked at runtime like AVX2, so only these functions are built for it
+#if ! SOS_CURVE_KERNELS_SSE2_BASELINE
+ #if defined (__clang__)
+  #pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+ #elif defined (__GNUC__)
+  #pragma GCC push_options
+  #pragma GCC target("sse2")
+ #endif
+#endif
+
+namespace Sse
+{
+    struct Ops
+    {
+        using Float = __m128;
+        using Int = __m128i;
+        using Mask = __m128;
+        static constexpr int width = 4;
+
+        static Float Load(const float* p) { return _mm_loadu_ps(p); }
+        static void Store(float* p, Float v) { _mm_storeu_ps(p, v); }
+        static Float Set(float v) { return _mm_set1_ps(v); }
+        static Int SetInt(int v) { return _mm_set1_epi32(v); }
+        static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+        static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+        static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+        static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+        static Float Sqrt(Float a) { return _mm_sqrt_ps(a); }
+        static Mask LessEqual(Float a, Float b) { return _mm_cmple_ps(a, b); }
+        static Float Select(Mask m, Float a, Float b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+        static Int IncrementWhere(Int i, Mask m) { return _mm_sub_epi32(i, _mm_castps_si128(m)); } //true lanes are -1
+        static Int ToInt(Float a) { return _mm_cvttps_epi32(a); }
+        static Float ToFloat(Int i) { return _mm_cvtepi32_ps(i); }
+        static Float Gather(const float* base, Int i, int stride)
+        {
+            alignas(16) int lanes[width];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), i);
+            return _mm_setr_ps(base[lanes[0] * stride], base[lanes[1] * stride], base[lanes[2] * stride], base[lanes[3] * stride]);
+        }
+    };
+
+    #include "CurveBlockKernelBody.h"
+}
+
+#if ! SOS_CURVE_KERNELS_SSE2_BASELINE
+ #if defined (__clang__)
+  #pragma clang attribute pop
+ #elif defined (__GNUC__)
+  #pragma GCC pop_options
+ #endif
+#endif
+
+//AVX2 is only used after checking the cpu at runtime, so only these functions are built for it
+#if defined (__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined (__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx2")
+#endif
+
+namespace Avx2
+{
+    struct Ops
+    {
+        using Float = __m256;
+        using Int = __m256i;
+        using Mask = __m256;
+        static constexpr int width = 8;
+
+        static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+        static void Store(float* p, Float v) { _mm256_storeu_ps(p, v); }
+        static Float Set(float v) { return _mm256_set1_ps(v); }
+        static Int SetInt(int v) { return _mm256_set1_epi32(v); }
+        static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+        static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+        static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+        static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+        static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+        static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+        static Float Sqrt(Float a) { return _mm256_sqrt_ps(a); }
+        static Mask LessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static Float Select(Mask m, Float a, Float b) { return _mm256_blendv_ps(b, a, m); }
+        static Int IncrementWhere(Int i, Mask m) { return _mm256_sub_epi32(i, _mm256_castps_si256(m)); } //true lanes are -1
+        static Int ToInt(Float a) { return _mm256_cvttps_epi32(a); }
+        static Float ToFloat(Int i) { return _mm256_cvtepi32_ps(i); }
+        static Float Gather(const float* base, Int i, int stride)
+        {
+            return _mm256_i32gather_ps(base, _mm256_mullo_epi32(i, _mm256_set1_epi32(stride)), 4);
+        }
+    };
+
+    #include "CurveBlockKernelBody.h"
+}
+
+#if defined (__clang__)
+ #pragma clang attribute pop
+#elif defined (__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#elif SOS_CURVE_KERNELS_ARM64
+namespace Neon
+{
+    struct Ops
+    {
+        using Float = float32x4_t;
+        using Int = int32x4_t;
+        using Mask = uint32x4_t;
+        static constexpr int width = 4;
+
+        static Float Load(const float* p) { return vld1q_f32(p); }
+        static void Store(float* p, Float v) { vst1q_f32(p, v); }
+        static Float Set(float v) { return vdupq_n_f32(v); }
+        static Int SetInt(int v) { return vdupq_n_s32(v); }
+        static Float Add(Float a, Float b) { return vaddq_f32(a, b); }
+        static Float Sub(Float a, Float b) { return vsubq_f32(a, b); }
+        static Float Mul(Float a, Float b) { return vmulq_f32(a, b); }
+        static Float Div(Float a, Float b) { return vdivq_f32(a, b); }
+        static Float Min(Float a, Float b) { return vminq_f32(a, b); }
+        static Float Max(Float a, Float b) { return vmaxq_f32(a, b); }
+        static Float Sqrt(Float a) { return vsqrtq_f32(a); }
+        static Mask LessEqual(Float a, Float b) { return vcleq_f32(a, b); }
+        static Float Select(Mask m, Float a, Float b) { return vbslq_f32(m, a, b); }
+        static Int IncrementWhere(Int i, Mask m) { return vsubq_s32(i, vreinterpretq_s32_u32(m)); } //true lanes are -1
+        static Int ToInt(Float a) { return vcvtq_s32_f32(a); }
+        static Float ToFloat(Int i) { return vcvtq_f32_s32(i); }
+        static Float Gather(const float* base, Int i, int stride)
+        {
+            alignas(16) int lanes[width];
+            vst1q_s32(lanes, i);
+            alignas(16) const float values[width] { base[lanes[0] * stride], base[lanes[1] * stride], base[lanes[2] * stride], base[lanes[3] * stride] };
+            return vld1q_f32(values);
+        }
+    };
+
+    #include "CurveBlockKernelBody.h"
+}
+#endif
+
+namespace Detail
+{
+    struct KernelSet
+    {
+        decltype(&Scalar::ProcessSegments<true>) processSegments;
+        decltype(&Scalar::ProcessSegments<false>) processLinearInX_Segments;
+        decltype(&Scalar::ProcessLookupTable) processLookupTable;
+        const char* name;
+    };
+
+   #if SOS_CURVE_KERNELS_X86
+    inline bool CpuHasAvx2()
+    {
+       #if defined (_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        //the OS also has to save the ymm registers
+        __cpuid(info, 1);
+        const auto osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesAvx && (info[1] & (1 << 5)) != 0;
+       #else
+        return __builtin_cpu_supports("avx2");
+       #endif
+    }
+
+    inline bool CpuHasSse2()
+    {
+       #if SOS_CURVE_KERNELS_SSE2_BASELINE
+        return true;
+       #elif defined (_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+       #else
+        return __builtin_cpu_supports("sse2");
+       #endif
+    }
+   #endif
+
+    inline KernelSet SelectKernels()
+    {
+       #if SOS_CURVE_KERNELS_X86
+        if (CpuHasAvx2())
+        {
+            return {Avx2::ProcessSegments<true>, Avx2::ProcessSegments<false>, Avx2::ProcessLookupTable, "AVX2"};
+        }
+        if (CpuHasSse2())
+        {
+            return {Sse::ProcessSegments<true>, Sse::ProcessSegments<false>, Sse::ProcessLookupTable, "SSE2"};
+        }
+       #elif SOS_CURVE_KERNELS_ARM64
+        return {Neon::ProcessSegments<true>, Neon::ProcessSegments<false>, Neon::ProcessLookupTable, "NEON"};
+       #endif
+        return {Scalar::ProcessSegments<true>, Scalar::ProcessSegments<false>, Scalar::ProcessLookupTable, "scalar"};
+    }
+
+    inline const KernelSet& GetKernels()
+    {
+        static const KernelSet kernels = SelectKernels();
+        return kernels;
+    }
+}
+
+inline void ProcessSegments(const QuadraticSegment* segments, size_t numSegments, bool allLinearInX, const float* in, float* out, int numSamples)
+{
+    if (numSegments == 0)
+    {
+        assert(false); //there has to be a connector at the end!
+        std::fill(out, out + numSamples, 0.0f);
+        return;
+    }
+    const auto& kernels = Detail::GetKernels();
+    (allLinearInX ? kernels.processLinearInX_Segments : kernels.processSegments)(segments, numSegments, in, out, numSamples);
+}
+
+inline void ProcessSegments(const QuadraticSegment* segments, size_t numSegments, const float* in, float* out, int numSamples)
+{
+    if (numSegments == 0)
+    {
+        assert(false); //there has to be a connector at the end!
+        std::fill(out, out + numSamples, 0.0f);
+        return;
+    }
+    const auto allLinearInX = std::none_of(segments, segments + numSegments, [](const QuadraticSegment& s) { return ! s.IsLinearInX(); });
+    ProcessSegments(segments, numSegments, allLinearInX, in, out, numSamples);
+}
+
+inline void ProcessLookupTable(const float* table, size_t numPoints, const float* in, float* out, int numSamples)
+{
+    assert(numPoints >= 2);
+    Detail::GetKernels().processLookupTable(table, numPoints, in, out, numSamples);
+}
+
+inline const char* GetInstructionSetName()
+{
+    return Detail::GetKernels().name;
+}
+
+}
+}
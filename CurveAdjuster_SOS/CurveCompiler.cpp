@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    CurveCompiler.cpp
+    Created: 17 Oct 2026 1:05:58pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CurveCompiler.h"
+#include "CurveAdjusterProcessor.h"
+
+namespace CurveAdjuster
+{
+
+CurveCompiler::CurveCompiler()
+: juce::Thread("curve compiler")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+CurveCompiler::~CurveCompiler()
+{
+    //every processor removes itself before letting go of the compiler
+    jassert(queue.empty());
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+}
+
+void CurveCompiler::Request(CurveAdjusterProcessor& processor)
+{
+    {
+        const juce::ScopedLock lock(queueLock);
+        if (std::find(queue.begin(), queue.end(), &processor) != queue.end())
+        {
+            return;
+        }
+        queue.push_back(&processor);
+    }
+    notify();
+}
+
+void CurveCompiler::Remove(CurveAdjusterProcessor& processor)
+{
+    const juce::ScopedLock compiling(compileLock);
+    const juce::ScopedLock lock(queueLock);
+    queue.erase(std::remove(queue.begin(), queue.end(), &processor), queue.end());
+}
+
+bool CurveCompiler::IsPending(const CurveAdjusterProcessor& processor) const
+{
+    const juce::ScopedLock lock(queueLock);
+    return beingCompiled == &processor || std::find(queue.begin(), queue.end(), &processor) != queue.end();
+}
+
+void CurveCompiler::run()
+{
+    while (! threadShouldExit())
+    {
+        {
+            const juce::ScopedLock compiling(compileLock);
+            CurveAdjusterProcessor* next = nullptr;
+            {
+                const juce::ScopedLock lock(queueLock);
+                if (! queue.empty())
+                {
+                    next = queue.front();
+                    queue.erase(queue.begin());
+                    beingCompiled = next;
+                }
+            }
+            //taken off the queue first, so an edit made during the compile queues it again
+            if (next != nullptr)
+            {
+                next->CompileInBackground();
+                const juce::ScopedLock lock(queueLock);
+                beingCompiled = nullptr;
+                continue;
+            }
+        }
+        wait(-1);
+    }
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    CurveCompiler.h
+    Created: 17 Oct 2026 1:05:58pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace CurveAdjuster
+{
+    class CurveAdjusterProcessor;
+
+    /*one low priority thread, shared through juce::SharedResourcePointer by every processor that has
+     background compilation on, that builds their snapshots (segments, lookup tables, adaptive knots,
+     ADAA integrals) and publishes them to the audio thread through the processor's SnapshotExchange.
+     a processor is queued at most once: edits that arrive while it waits are picked up by the one
+     compile, which always reads the newest curve, so a drag never builds positions it has moved past*/
+    class CurveCompiler : private juce::Thread
+    {
+    public:
+        CurveCompiler();
+        ~CurveCompiler() override;
+
+        //queues processor unless it's already queued. any thread but the audio thread
+        void Request(CurveAdjusterProcessor& processor);
+        //takes processor out of the queue and waits for a compile of it that's running
+        void Remove(CurveAdjusterProcessor& processor);
+        //true while processor is queued or being compiled
+        bool IsPending(const CurveAdjusterProcessor& processor) const;
+
+    private:
+        void run() override;
+
+        juce::CriticalSection compileLock; //held while compiling, so Remove can wait for it
+        juce::CriticalSection queueLock;
+        std::vector<CurveAdjusterProcessor*> queue; //guarded by queueLock, oldest first
+        CurveAdjusterProcessor* beingCompiled {nullptr}; //guarded by queueLock, the one being compiled now
+
+        JUCE_DECLARE_NON_COPYABLE(CurveCompiler)
+    };
+}
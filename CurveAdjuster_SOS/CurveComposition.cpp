@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    CurveComposition.cpp
+    Created: 17 Oct 2026 12:50:47pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CurveComposition.h"
+
+namespace CurveAdjuster
+{
+
+CurveComposition::CurveComposition(std::vector<CurveAdjusterProcessor*> _stages, size_t _numPoints)
+: stages(std::move(_stages)),
+  numPoints(std::max(_numPoints, CurveLookupTable::minNumPoints)),
+  tables(CurveLookupTable())
+{
+    Rebuild();
+    tables.Update();
+    for (auto* stage : stages)
+    {
+        stage->AddListener(this);
+    }
+}
+
+CurveComposition::~CurveComposition()
+{
+    for (auto* stage : stages)
+    {
+        stage->RemoveListener(this);
+    }
+}
+
+float CurveComposition::GetTranslatedOutput(float x)
+{
+    return tables.Acquire().GetValue(x);
+}
+
+void CurveComposition::ProcessBlock(const float* in, float* out, int numSamples)
+{
+    const auto& table = tables.Acquire();
+    BlockKernels::ProcessLookupTable(table.GetData(), table.GetNumPoints(), in, out, numSamples);
+}
+
+void CurveComposition::CurveChanged(CurveAdjusterProcessor&)
+{
+    Rebuild();
+}
+
+void CurveComposition::Rebuild()
+{
+    const juce::ScopedLock lock(writerLock);
+    
+    const auto isStale = builtGenerations.size() != stages.size()
+        || ! std::equal(stages.begin(), stages.end(), builtGenerations.begin(), [](const CurveAdjusterProcessor* stage, uint64_t built)
+           {
+               return stage->GetGeneration() == built;
+           });
+    if (! isStale)
+    {
+        return;
+    }
+    
+    std::vector<CurveSnapshot> curves;
+    curves.reserve(stages.size());
+    builtGenerations.clear();
+    for (auto* stage : stages)
+    {
+        curves.push_back(stage->GetCurveCopy());
+        builtGenerations.push_back(curves.back().generation);
+    }
+    std::vector<SegmentCursor> cursors(curves.size());
+    
+    auto& table = tables.GetWriteBuffer();
+    if (table.GetNumPoints() != numPoints)
+    {
+        table.Resize(numPoints);
+    }
+    table.Fill([&curves, &cursors](float x)
+    {
+        for (size_t i = 0; i < curves.size(); ++i)
+        {
+            //same clamp GetTranslatedOutput applies between stages
+            x = curves[i].GetY_FromSegments(juce::jlimit(0.0f, 1.0f, x), cursors[i]);
+        }
+        return x;
+    });
+    tables.Publish();
+}
+
+}
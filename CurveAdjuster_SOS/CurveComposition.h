@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    CurveComposition.h
+    Created: 17 Oct 2026 12:50:47pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CurveAdjusterProcessor.h"
+
+namespace CurveAdjuster
+{
+    /*several CurveAdjusterProcessors chained (the output of one is the input of the next) fused into one
+     lookup table, so the audio thread pays for one lookup instead of one per stage. smooth the input
+     once before it instead of smoothing every stage.
+     the table is rebuilt whenever one of the stages gets a new curve, on the thread that set it
+     (and only then, a notification for a curve already in the table is skipped).
+     stages are evaluated from their segments, their own lookup table and crossfade settings don't apply.
+     the stages have to outlive the composition*/
+    class CurveComposition : private CurveAdjusterProcessor::Listener
+    {
+    public:
+        //stages[0] is applied first. steep stages want more points, see CurveLookupTable
+        CurveComposition(std::vector<CurveAdjusterProcessor*> _stages, size_t numPoints = 2048);
+        ~CurveComposition() override;
+
+        //audio thread
+        float GetTranslatedOutput(float x);
+        //inputs are clamped to 0-1, in == out is allowed
+        void ProcessBlock(const float* in, float* out, int numSamples);
+
+    private:
+        void CurveChanged(CurveAdjusterProcessor& processor) override;
+        void Rebuild();
+
+        const std::vector<CurveAdjusterProcessor*> stages;
+        const size_t numPoints;
+
+        juce::CriticalSection writerLock; //stages can change on different threads
+        std::vector<uint64_t> builtGenerations; //of each stage, for the table last published. guarded by writerLock
+        SnapshotExchange<CurveLookupTable> tables;
+    };
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    CurveKernel.h
+    Created: 17 Oct 2026 12:53:18pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+/*everything needed to evaluate a curve, header only and without JUCE, for headless renders,
+ benchmarks and anything else that shouldn't link the GUI stack. CurveAdjusterProcessor runs
+ its audio thread on these same types, so results match it exactly*/
+#include "AdaptiveLookupTable.h"
+#include "BakedCurve.h"
+#include "CurveBlockKernels.h"
+#include "CurveLookupTable.h"
+#include "CurveSnapshot.h"
+#include "DirtyRange.h"
+#include "FixedPointLookupTable.h"
+#include "LinearSmoother.h"
+#include "QuadraticSegment.h"
+#include "SegmentBuilder.h"
+#include "SegmentCursor.h"
+#include "SnapshotExchange.h"
+#include "VoiceSmoothers.h"
+
+namespace CurveAdjuster
+{
+    /*one curve with a smoother, for a single thread (use CurveAdjusterProcessor when the curve is
+     edited from another thread). nothing allocates after construction except EnableLookupTable*/
+    class CurveKernel
+    {
+    public:
+        CurveKernel(size_t maxConnectors, float initVal, double rampLength)
+        : snapshot(maxConnectors), smoother(initVal, rampLength)
+        {
+        }
+
+        //connectors in 0-1 coordinates, in order, the last ending at x = 1
+        void SetCurve(const ConnectorDefinition* connectors, size_t numConnectors)
+        {
+            assert(numConnectors <= snapshot.segments.size()); //too many connectors!
+            numConnectors = std::min(numConnectors, snapshot.segments.size());
+            SegmentBuilder::BuildSegments([connectors](size_t i) { return connectors[i]; }, numConnectors, snapshot.segments.data());
+            snapshot.numSegments = numConnectors;
+            snapshot.UpdateSegmentSummaries();
+            snapshot.UpdateLookupTable(lookupTableSize, lookupTableFormat);
+            snapshot.UpdateAdaptiveTable(adaptiveTableMaxError);
+        }
+
+        template <size_t numConnectors>
+        void SetCurve(const CurveDefinition<numConnectors>& definition)
+        {
+            SetCurve(definition.data(), numConnectors);
+        }
+
+        //0 points turns the table off again, see CurveAdjusterProcessor::EnableLookupTable
+        void SetLookupTable(size_t numPoints, LookupTableFormat format = LookupTableFormat::floatingPoint)
+        {
+            lookupTableSize = numPoints == 0 ? 0 : std::max(numPoints, CurveLookupTable::minNumPoints);
+            lookupTableFormat = format;
+            adaptiveTableMaxError = 0.0f;
+            snapshot.UpdateLookupTable(lookupTableSize, lookupTableFormat);
+            snapshot.UpdateAdaptiveTable(0.0f);
+        }
+
+        //0 turns the table off again, see CurveAdjusterProcessor::EnableAdaptiveLookupTable
+        AdaptiveTableReport SetAdaptiveLookupTable(float maxError)
+        {
+            adaptiveTableMaxError = std::max(maxError, 0.0f);
+            lookupTableSize = 0;
+            snapshot.UpdateLookupTable(0, lookupTableFormat);
+            return snapshot.UpdateAdaptiveTable(adaptiveTableMaxError);
+        }
+
+        void Reset(double sampleRate)
+        {
+            smoother.Reset(sampleRate);
+        }
+
+        float GetTranslatedOutput(float x)
+        {
+            return snapshot.GetY_AtX(std::clamp(x, 0.0f, 1.0f), cursor);
+        }
+
+        //inputs are clamped to 0-1, in == out is allowed
+        void ProcessBlock(const float* in, float* out, int numSamples)
+        {
+            snapshot.Process(in, out, numSamples);
+        }
+
+        //like CurveAdjusterProcessor::ProcessSmoothedBlock
+        void ProcessSmoothedBlock(float target, float* out, int numSamples)
+        {
+            if (smoother.GetNextBlock(target, out, numSamples))
+            {
+                std::fill(out, out + numSamples, GetTranslatedOutput(smoother.value));
+                return;
+            }
+            snapshot.Process(out, out, numSamples);
+        }
+
+        const CurveSnapshot& GetSnapshot() const
+        {
+            return snapshot;
+        }
+
+    private:
+        CurveSnapshot snapshot;
+        SegmentCursor cursor;
+        LinearSmoother smoother;
+        size_t lookupTableSize {0};
+        LookupTableFormat lookupTableFormat {LookupTableFormat::floatingPoint};
+        float adaptiveTableMaxError {0.0f};
+    };
+}
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    CurveLookupTable.h
+    Created: 17 Oct 2026 12:35:18pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace CurveAdjuster
+{
+    /*evenly spaced samples of a curve over x = 0 to 1.
+     GetValue is one indexed linear interpolation, no matter how many connectors the curve has.
+     interpolation error is about h^2 / 8 times the curvature, h = 1 / (numPoints - 1),
+     so 256 points suits gentle curves while steep ones (binary, staircase) want 4096 or more*/
+    class CurveLookupTable
+    {
+    public:
+        static constexpr size_t minNumPoints {2};
+
+        //allocates, so call from the message thread
+        void Resize(size_t numPoints)
+        {
+            numPoints = std::max(numPoints, minNumPoints);
+            table.assign(numPoints, 0.0f);
+            scale = static_cast<float>(numPoints - 1);
+        }
+
+        //copies a table that was sampled elsewhere (e.g. a BakedCurve), allocates
+        void Assign(const float* values, size_t numPoints)
+        {
+            Resize(numPoints);
+            std::copy(values, values + table.size(), table.begin());
+        }
+
+        void Clear()
+        {
+            table.clear();
+            table.shrink_to_fit();
+        }
+
+        template <typename Function>
+        void Fill(Function&& getY_AtX)
+        {
+            FillRange(0.0f, 1.0f, getY_AtX);
+        }
+
+        //resamples only the points from startX to endX, rounded out to the points around them
+        template <typename Function>
+        void FillRange(float startX, float endX, Function&& getY_AtX)
+        {
+            if (table.empty())
+            {
+                return;
+            }
+            const auto first = static_cast<size_t>(std::floor(std::clamp(startX, 0.0f, 1.0f) * scale));
+            const auto last = std::min(static_cast<size_t>(std::ceil(std::clamp(endX, 0.0f, 1.0f) * scale)), table.size() - 1);
+            for (size_t i = first; i <= last; ++i)
+            {
+                table[i] = getY_AtX(static_cast<float>(i) / scale);
+            }
+        }
+
+        float GetValue(float in_X) const
+        {
+            const float position = std::clamp(in_X, 0.0f, 1.0f) * scale;
+            const auto index = std::min(static_cast<size_t>(position), table.size() - 2);
+            const float fraction = position - static_cast<float>(index);
+            return table[index] + fraction * (table[index + 1] - table[index]);
+        }
+
+        const float* GetData() const
+        {
+            return table.data();
+        }
+
+        size_t GetNumPoints() const
+        {
+            return table.size();
+        }
+
+        bool IsEmpty() const
+        {
+            return table.empty();
+        }
+
+    private:
+        std::vector<float> table;
+        float scale {1.0f};
+    };
+}
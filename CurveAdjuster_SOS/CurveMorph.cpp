@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+
+    CurveMorph.cpp
+    Created: 17 Oct 2026 12:51:14pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CurveMorph.h"
+
+namespace CurveAdjuster
+{
+
+//==============================================================================
+MorphWeights MorphWeights::Crossfade(float position, size_t numShapes)
+{
+    MorphWeights weights;
+    numShapes = juce::jlimit(static_cast<size_t>(1), maxShapes, numShapes);
+    const auto scaled = juce::jlimit(0.0f, 1.0f, position) * static_cast<float>(numShapes - 1);
+    const auto lower = juce::jmin(static_cast<size_t>(scaled), numShapes - 1);
+    const auto fraction = scaled - static_cast<float>(lower);
+    weights.values[lower] = 1.0f - fraction;
+    if (lower + 1 < numShapes)
+    {
+        weights.values[lower + 1] = fraction;
+    }
+    return weights;
+}
+
+MorphWeights MorphWeights::XY(pointType point, const std::array<pointType, maxShapes>& shapePositions, size_t numShapes)
+{
+    MorphWeights weights;
+    numShapes = juce::jlimit(static_cast<size_t>(1), maxShapes, numShapes);
+    auto sum = 0.0f;
+    for (size_t i = 0; i < numShapes; ++i)
+    {
+        const auto distanceSquared = point.getDistanceSquaredFrom(shapePositions[i]);
+        if (distanceSquared < 1.0e-12f)
+        {
+            //on top of a shape
+            weights.values.fill(0.0f);
+            weights.values[i] = 1.0f;
+            return weights;
+        }
+        weights.values[i] = 1.0f / distanceSquared;
+        sum += weights.values[i];
+    }
+    for (size_t i = 0; i < numShapes; ++i)
+    {
+        weights.values[i] /= sum;
+    }
+    return weights;
+}
+
+//==============================================================================
+CurveMorph::InterleavedTable::InterleavedTable(size_t _numPoints)
+: numPoints(juce::jmax(_numPoints, CurveLookupTable::minNumPoints)),
+  scale(static_cast<float>(numPoints - 1)),
+  storage(numPoints * MorphWeights::maxShapes + alignment / sizeof(float), 0.0f)
+{
+    auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+    rows = storage.data() + ((alignment - address % alignment) % alignment) / sizeof(float);
+}
+
+CurveMorph::InterleavedTable::InterleavedTable(const InterleavedTable& other)
+: InterleavedTable(other.numPoints)
+{
+    std::copy(other.rows, other.rows + numPoints * MorphWeights::maxShapes, rows);
+}
+
+float CurveMorph::InterleavedTable::GetValue(float in_X, const float* weights) const
+{
+    const float position = juce::jlimit(0.0f, 1.0f, in_X) * scale;
+    const auto index = juce::jmin(static_cast<size_t>(position), numPoints - 2);
+    const float fraction = position - static_cast<float>(index);
+    
+    //fixed width loops over two aligned rows, compiled to a handful of vector multiply-adds
+    const auto* lower = rows + index * MorphWeights::maxShapes;
+    const auto* upper = lower + MorphWeights::maxShapes;
+    auto lowerY = 0.0f;
+    auto upperY = 0.0f;
+    for (size_t shape = 0; shape < MorphWeights::maxShapes; ++shape)
+    {
+        lowerY += weights[shape] * lower[shape];
+        upperY += weights[shape] * upper[shape];
+    }
+    return lowerY + fraction * (upperY - lowerY);
+}
+
+float* CurveMorph::InterleavedTable::GetRow(size_t index)
+{
+    return rows + index * MorphWeights::maxShapes;
+}
+
+size_t CurveMorph::InterleavedTable::GetNumPoints() const
+{
+    return numPoints;
+}
+
+//==============================================================================
+CurveMorph::CurveMorph(std::string n, size_t numShapes, size_t numPoints)
+: name(n),
+  shapes(juce::jlimit(static_cast<size_t>(1), MorphWeights::maxShapes, numShapes), {{{0.0f, 0.0f}, {0.25f, 0.25f}, {1.0f, 1.0f}}}),
+  tables(InterleavedTable(numPoints))
+{
+    jassert(numShapes >= 1 && numShapes <= MorphWeights::maxShapes);
+    {
+        const juce::ScopedLock lock(writerLock);
+        PublishTables();
+    }
+    tables.Update();
+}
+
+void CurveMorph::SetShape(size_t shape, const std::vector<ConnectorPoints>& connectorPoints)
+{
+    const juce::ScopedLock lock(writerLock);
+    jassert(shape < shapes.size());
+    if (shape < shapes.size())
+    {
+        shapes[shape] = connectorPoints;
+        PublishTables();
+    }
+}
+
+std::vector<ConnectorPoints> CurveMorph::GetShape(size_t shape) const
+{
+    const juce::ScopedLock lock(writerLock);
+    jassert(shape < shapes.size());
+    return shape < shapes.size() ? shapes[shape] : std::vector<ConnectorPoints>();
+}
+
+size_t CurveMorph::GetNumShapes() const
+{
+    return shapes.size(); //fixed at construction
+}
+
+float CurveMorph::GetTranslatedOutput(float x, const MorphWeights& weights)
+{
+    return tables.Acquire().GetValue(x, weights.values.data());
+}
+
+void CurveMorph::ProcessBlock(const float* in, float* out, int numSamples, const MorphWeights& startWeights, const MorphWeights& endWeights)
+{
+    const auto& table = tables.Acquire();
+    std::array<float, MorphWeights::maxShapes> weights;
+    std::array<float, MorphWeights::maxShapes> weightSteps;
+    for (size_t shape = 0; shape < MorphWeights::maxShapes; ++shape)
+    {
+        weightSteps[shape] = (endWeights.values[shape] - startWeights.values[shape]) / static_cast<float>(juce::jmax(1, numSamples));
+        weights[shape] = startWeights.values[shape];
+    }
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (size_t shape = 0; shape < MorphWeights::maxShapes; ++shape)
+        {
+            weights[shape] += weightSteps[shape];
+        }
+        out[i] = table.GetValue(in[i], weights.data());
+    }
+}
+
+void CurveMorph::SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo)
+{
+    juce::ValueTree temp {name};
+    {
+        const juce::ScopedLock lock(writerLock);
+        for (size_t i = 0; i < shapes.size(); ++i)
+        {
+            temp.appendChild(CurveStateSerialisation::CreateTree(juce::String("shape" + std::to_string(i)), shapes[i]), nullptr);
+        }
+    }
+    
+    if (stateToAppendTo.state.getChildWithName(name).isValid())
+    {
+        stateToAppendTo.state.getChildWithName(name).copyPropertiesAndChildrenFrom(temp, nullptr);
+    }
+    else
+    {
+        stateToAppendTo.state.appendChild(temp, nullptr);
+    }
+}
+
+void CurveMorph::LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree)
+{
+    auto morphTree = apvtsTree.getChildWithName(name);
+    if (morphTree.isValid())
+    {
+        SetState(morphTree);
+        apvtsTree.removeChild(morphTree, nullptr);
+    }
+}
+
+const juce::Identifier& CurveMorph::GetName() const
+{
+    return name;
+}
+
+void CurveMorph::SetState(juce::ValueTree& morphTree)
+{
+    const juce::ScopedLock lock(writerLock);
+    for (size_t i = 0; i < shapes.size(); ++i)
+    {
+        //shapes missing from the preset keep what they had. shapes are sized as they are set, so any length loads
+        std::vector<ConnectorPoints> loadedPoints;
+        if (CurveStateSerialisation::Load(morphTree.getChildWithName(juce::String("shape" + std::to_string(i))), loadedPoints, std::numeric_limits<size_t>::max()))
+        {
+            shapes[i] = loadedPoints;
+        }
+    }
+    //all shapes reach the audio thread together
+    PublishTables();
+}
+
+void CurveMorph::PublishTables()
+{
+    auto& table = tables.GetWriteBuffer();
+    const auto numPoints = table.GetNumPoints();
+    const auto scale = static_cast<float>(numPoints - 1);
+    for (size_t shape = 0; shape < shapes.size(); ++shape)
+    {
+        CurveSnapshot curve(shapes[shape].size());
+        const auto& points = shapes[shape];
+        SegmentBuilder::BuildSegments([&points](size_t i) { return points[i].ToDefinition(); }, points.size(), curve.segments.data());
+        jassert(shapes[shape].empty() || juce::approximatelyEqual(shapes[shape].back().end.x, 1.0f)); //there has to be a connector at the end!
+        curve.numSegments = shapes[shape].size();
+        
+        SegmentCursor cursor;
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            table.GetRow(i)[shape] = curve.GetY_FromSegments(static_cast<float>(i) / scale, cursor);
+        }
+    }
+    tables.Publish();
+}
+
+}
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    CurveMorph.h
+    Created: 17 Oct 2026 12:51:14pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "CurveStateSerialisation.h"
+#include "CurveSnapshot.h"
+#include "SnapshotExchange.h"
+#include <array>
+
+namespace CurveAdjuster
+{
+    //how much of each shape a CurveMorph blends, the values sum to 1
+    struct MorphWeights
+    {
+        static constexpr size_t maxShapes {8};
+
+        /*position 0 to 1 walks through the shapes in order, crossfading neighbours:
+         with 2 shapes it is a plain crossfade, with 3, 0.5 is all of the middle one*/
+        static MorphWeights Crossfade(float position, size_t numShapes);
+
+        /*each shape sits at a point on an XY pad, the weights fall off with the squared distance to
+         point (inverse distance weighting), so a shape's own point gives all of that shape*/
+        static MorphWeights XY(pointType point, const std::array<pointType, maxShapes>& shapePositions, size_t numShapes);
+
+        std::array<float, maxShapes> values {};
+    };
+
+    /*up to MorphWeights::maxShapes curves for one parameter, blended continuously.
+     every shape is sampled into one interleaved table (all shapes' values for an x side by side, 32 byte
+     aligned), so a morphed lookup is two rows of multiply-adds instead of solving any segments.
+     shapes use the same connectors as CurveAdjusterProcessor and save in the same layout*/
+    class CurveMorph
+    {
+    public:
+        CurveMorph(std::string n, size_t numShapes, size_t numPoints = 1024);
+
+        //not for the audio thread: the tables are rebuilt on the calling thread
+        void SetShape(size_t shape, const std::vector<ConnectorPoints>& connectorPoints);
+        std::vector<ConnectorPoints> GetShape(size_t shape) const;
+        size_t GetNumShapes() const;
+
+        //audio thread
+        float GetTranslatedOutput(float x, const MorphWeights& weights);
+        /*maps a block with the weights moving linearly from startWeights to endWeights,
+         so a modulated morph doesn't step at block boundaries. in == out is allowed*/
+        void ProcessBlock(const float* in, float* out, int numSamples, const MorphWeights& startWeights, const MorphWeights& endWeights);
+
+        //every shape as a child of one tree under name, see CurveStateSerialisation
+        void SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo);
+        void LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree);
+        const juce::Identifier& GetName() const;
+
+    private:
+        //row i holds every shape's y at x = i / (numPoints - 1), rows are maxShapes floats
+        class InterleavedTable
+        {
+        public:
+            explicit InterleavedTable(size_t numPoints);
+            InterleavedTable(const InterleavedTable& other);
+            InterleavedTable& operator=(const InterleavedTable& other) = delete;
+
+            float GetValue(float in_X, const float* weights) const;
+            float* GetRow(size_t index);
+            size_t GetNumPoints() const;
+
+        private:
+            static constexpr size_t alignment {32};
+            size_t numPoints;
+            float scale;
+            std::vector<float> storage; //over allocated so rows can start on an aligned address
+            float* rows;
+        };
+
+        void SetState(juce::ValueTree& morphTree);
+        void PublishTables(); //caller holds writerLock
+
+        const juce::Identifier name;
+
+        juce::CriticalSection writerLock;
+        std::vector<std::vector<ConnectorPoints>> shapes; //guarded by writerLock
+
+        SnapshotExchange<InterleavedTable> tables;
+    };
+}
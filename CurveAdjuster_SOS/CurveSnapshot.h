@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+    CurveSnapshot.h
+    Created: 17 Oct 2026 12:39:40pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "QuadraticSegment.h"
+#include "AdaptiveLookupTable.h"
+#include "CurveLookupTable.h"
+#include "FixedPointLookupTable.h"
+#include "CurveBlockKernels.h"
+#include "DirtyRange.h"
+#include "SegmentCursor.h"
+#include <cstdint>
+#include <vector>
+
+namespace CurveAdjuster
+{
+    enum class LookupTableFormat
+    {
+        floatingPoint, //4 bytes per point
+        fixedPoint16   //2 bytes per point, see FixedPointLookupTable
+    };
+
+    struct CurveValueAndSlope
+    {
+        float y {0.0f};
+        float slope {0.0f};           //dy/dx at the input
+        float segmentMaxSlope {0.0f}; //steepest |dy/dx| of the segment the input is in
+    };
+
+    /*everything the audio thread needs to evaluate one version of a curve.
+     built in full by the writer, then treated as immutable once published*/
+    struct CurveSnapshot
+    {
+        explicit CurveSnapshot(size_t maxSegments)
+        : segments(maxSegments), maxSlopes(maxSegments, 0.0f), areasBefore(maxSegments, 0.0)
+        {
+        }
+
+        //uses a lookup table when there is one (this snapshot's or the shared one), otherwise solves the segments
+        float GetY_AtX(float in_X, SegmentCursor& cursor) const
+        {
+            const auto& tables = GetTables();
+            if (! tables.lookupTable.IsEmpty())
+            {
+                return tables.lookupTable.GetValue(in_X);
+            }
+            if (! tables.fixedPointTable.IsEmpty())
+            {
+                return tables.fixedPointTable.GetValue(in_X);
+            }
+            if (! tables.adaptiveTable.IsEmpty())
+            {
+                return tables.adaptiveTable.GetValue(in_X);
+            }
+            return GetY_FromSegments(in_X, cursor);
+        }
+
+        float GetY_FromSegments(float in_X, SegmentCursor& cursor) const
+        {
+            if (numSegments == 0)
+            {
+                return 0.0f;
+            }
+            return segments[cursor.Find(segments.data(), numSegments, in_X)].GetY_AtX(in_X);
+        }
+
+        //always solves the segments, a lookup table has no slope to offer
+        CurveValueAndSlope GetY_AndSlope_AtX(float in_X, SegmentCursor& cursor) const
+        {
+            if (numSegments == 0)
+            {
+                return {};
+            }
+            const auto index = cursor.Find(segments.data(), numSegments, in_X);
+            const auto& segment = segments[index];
+            const auto t = segment.GetT_AtX(in_X);
+            return {segment.GetY_AtT(t), segment.GetSlope_AtT(t), maxSlopes[index]};
+        }
+
+        /*integral of the curve from 0 to in_X, with the curve held at its end values outside 0-1.
+         solves the segments, like GetY_AndSlope_AtX*/
+        double GetAntiderivative(double in_X, SegmentCursor& cursor) const
+        {
+            if (numSegments == 0)
+            {
+                return 0.0;
+            }
+            const auto clampedX = static_cast<float>(std::clamp(in_X, 0.0, 1.0));
+            const auto index = cursor.Find(segments.data(), numSegments, clampedX);
+            const auto& segment = segments[index];
+            const auto t = segment.GetT_AtX(clampedX);
+            return areasBefore[index] + segment.GetArea_AtT(t) + static_cast<double>(segment.GetY_AtT(t)) * (in_X - clampedX);
+        }
+
+        void Process(const float* in, float* out, int numSamples) const
+        {
+            const auto& tables = GetTables();
+            if (! tables.lookupTable.IsEmpty())
+            {
+                BlockKernels::ProcessLookupTable(tables.lookupTable.GetData(), tables.lookupTable.GetNumPoints(), in, out, numSamples);
+            }
+            else if (! tables.fixedPointTable.IsEmpty())
+            {
+                tables.fixedPointTable.Process(in, out, numSamples);
+            }
+            else if (! tables.adaptiveTable.IsEmpty())
+            {
+                tables.adaptiveTable.Process(in, out, numSamples);
+            }
+            else
+            {
+                BlockKernels::ProcessSegments(segments.data(), numSegments, allLinearInX, in, out, numSamples);
+            }
+        }
+
+        //the snapshot whose tables GetY_AtX and Process use
+        const CurveSnapshot& GetTables() const
+        {
+            return sharedTables != nullptr ? *sharedTables : *this;
+        }
+
+        //call after changing segments, from the first one that changed (the ones before keep their summaries)
+        void UpdateSegmentSummaries(size_t firstChanged = 0)
+        {
+            firstChanged = std::min(firstChanged, numSegments);
+            auto area = firstChanged > 0 ? areasBefore[firstChanged - 1] + segments[firstChanged - 1].GetArea_AtT(1.0) : 0.0;
+            for (size_t i = firstChanged; i < numSegments; ++i)
+            {
+                maxSlopes[i] = segments[i].GetMaxAbsSlope();
+                areasBefore[i] = area;
+                area += segments[i].GetArea_AtT(1.0);
+            }
+            maxSlope = 0.0f;
+            allLinearInX = true;
+            for (size_t i = 0; i < numSegments; ++i)
+            {
+                maxSlope = std::max(maxSlope, maxSlopes[i]);
+                allLinearInX = allLinearInX && segments[i].IsLinearInX();
+            }
+        }
+
+        /*like UpdateLookupTable, but when the table already has numPoints in this format only the inputs in
+         dirty are resampled. the rest of the table has to match the segments already*/
+        void UpdateLookupTable(size_t numPoints, LookupTableFormat format, const DirtyRange& dirty)
+        {
+            const auto isFloat = format == LookupTableFormat::floatingPoint;
+            const auto pointsInTable = isFloat ? lookupTable.GetNumPoints() : fixedPointTable.GetNumPoints();
+            const auto pointsInOther = isFloat ? fixedPointTable.GetNumPoints() : lookupTable.GetNumPoints();
+            if (numPoints == 0 || pointsInTable != numPoints || pointsInOther != 0)
+            {
+                UpdateLookupTable(numPoints, format);
+                return;
+            }
+            if (dirty.IsEmpty())
+            {
+                return;
+            }
+            SegmentCursor cursor;
+            auto getY = [this, &cursor](float x) { return GetY_FromSegments(x, cursor); };
+            if (isFloat)
+            {
+                lookupTable.FillRange(dirty.startX, dirty.endX, getY);
+            }
+            else
+            {
+                fixedPointTable.FillRange(dirty.startX, dirty.endX, getY);
+            }
+        }
+
+        //samples the segments into a table of numPoints in the given format, or removes the tables when numPoints is 0
+        void UpdateLookupTable(size_t numPoints, LookupTableFormat format)
+        {
+            const auto useFloat = numPoints != 0 && format == LookupTableFormat::floatingPoint;
+            const auto useFixedPoint = numPoints != 0 && format == LookupTableFormat::fixedPoint16;
+            
+            //the tables are filled in increasing x, so a local cursor only ever steps to the next segment
+            SegmentCursor cursor;
+            auto getY = [this, &cursor](float x) { return GetY_FromSegments(x, cursor); };
+            
+            if (! useFloat)
+            {
+                lookupTable.Clear();
+            }
+            else
+            {
+                if (lookupTable.GetNumPoints() != numPoints)
+                {
+                    lookupTable.Resize(numPoints);
+                }
+                lookupTable.Fill(getY);
+            }
+            
+            if (! useFixedPoint)
+            {
+                fixedPointTable.Clear();
+            }
+            else
+            {
+                if (fixedPointTable.GetNumPoints() != numPoints)
+                {
+                    fixedPointTable.Resize(numPoints);
+                }
+                fixedPointTable.Fill(getY);
+            }
+        }
+
+        //builds the adaptive table to within maxError of the segments, or removes it when maxError is 0
+        AdaptiveTableReport UpdateAdaptiveTable(float maxError)
+        {
+            if (maxError <= 0.0f)
+            {
+                adaptiveTable.Clear();
+                return {};
+            }
+            return adaptiveTable.Build(segments.data(), numSegments, maxError);
+        }
+
+        std::vector<QuadraticSegment> segments; //sized once, never reallocated
+        size_t numSegments {0};
+        uint64_t generation {0}; //of the curve the segments were built from, see ICurveAdjusterProcessor::GetGeneration
+        std::vector<float> maxSlopes; //per segment, see QuadraticSegment::GetMaxAbsSlope
+        float maxSlope {0.0f};        //of the whole curve
+        bool allLinearInX {false};    //picks the block kernel once per snapshot instead of once per Process call
+        std::vector<double> areasBefore; //per segment, the integral of the curve up to its startX
+        CurveLookupTable lookupTable;
+        FixedPointLookupTable fixedPointTable;
+        AdaptiveLookupTable adaptiveTable;
+        /*when set, tables compiled once for every snapshot of an identical curve (see CompiledCurveCache)
+         are used instead of this snapshot's own, which are then left empty. the owner keeps it alive*/
+        const CurveSnapshot* sharedTables {nullptr};
+    };
+}
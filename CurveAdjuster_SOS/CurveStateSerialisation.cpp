@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    CurveStateSerialisation.cpp
+    Created: 17 Oct 2026 12:49:33pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#include "CurveStateSerialisation.h"
+
+namespace CurveAdjuster
+{
+namespace CurveStateSerialisation
+{
+
+static const juce::Identifier connectors_ID {"control_coordinates"};
+static const juce::Identifier value_string_as_ID {"value"};
+
+juce::ValueTree CreateTree(const juce::Identifier& name, const std::vector<ConnectorPoints>& connectorPoints)
+{
+    juce::ValueTree temp
+    { name, {},
+        {
+            { connectors_ID , {},}
+        }
+    };
+    
+    //iterate through any handles and add to the temp tree
+    for (size_t i = 0; i < connectorPoints.size(); ++i)
+    {
+        const auto& c = connectorPoints[i];
+        //create tree for the point
+        juce::Identifier connectorName = juce::String("connector" + std::to_string(i));
+        juce::ValueTree connectorTree
+        { connectorName, {},
+            {
+                {"startX", {{value_string_as_ID, c.start.x}}},
+                {"startY", {{value_string_as_ID, c.start.y}}},
+                {"controlX", {{value_string_as_ID, c.control.x}}},
+                {"controlY", {{value_string_as_ID, c.control.y}}},
+                {"endX", {{value_string_as_ID, c.end.x}}},
+                {"endY", {{value_string_as_ID, c.end.y}}},
+                {"type", {{value_string_as_ID, static_cast<int>(c.type)}}}
+            }
+        };
+        
+        //add pointTree to "handle coordinates" in temptree
+        temp.getChildWithName(connectors_ID).appendChild(connectorTree, nullptr);
+    }
+    return temp;
+}
+
+//writes into a tree saved before with the same number of connectors. setProperty ignores values that
+//didn't change, so only the edited connectors are touched and only they notify the tree's listeners
+static bool UpdateInPlace(juce::ValueTree& existing, const juce::ValueTree& temp)
+{
+    auto existingConnectors = existing.getChildWithName(connectors_ID);
+    const auto newConnectors = temp.getChildWithName(connectors_ID);
+    if (! existingConnectors.isValid() || existingConnectors.getNumChildren() != newConnectors.getNumChildren())
+    {
+        return false;
+    }
+    for (auto i = 0; i < newConnectors.getNumChildren(); ++i)
+    {
+        auto existingConnector = existingConnectors.getChild(i);
+        const auto newConnector = newConnectors.getChild(i);
+        if (existingConnector.getType() != newConnector.getType() || existingConnector.getNumChildren() != newConnector.getNumChildren())
+        {
+            return false;
+        }
+    }
+    for (auto i = 0; i < newConnectors.getNumChildren(); ++i)
+    {
+        auto existingConnector = existingConnectors.getChild(i);
+        const auto newConnector = newConnectors.getChild(i);
+        for (auto j = 0; j < newConnector.getNumChildren(); ++j)
+        {
+            const auto field = newConnector.getChild(j);
+            existingConnector.getOrCreateChildWithName(field.getType(), nullptr).setProperty(value_string_as_ID, field.getProperty(value_string_as_ID), nullptr);
+        }
+    }
+    return true;
+}
+
+void Save(juce::AudioProcessorValueTreeState& stateToAppendTo, const juce::Identifier& name, const std::vector<ConnectorPoints>& connectorPoints)
+{
+    auto temp = CreateTree(name, connectorPoints);
+    
+    //DBG(temp.toXmlString());
+    
+    auto existing = stateToAppendTo.state.getChildWithName(name);
+    if (existing.isValid())
+    {
+        if (! UpdateInPlace(existing, temp))
+        {
+            existing.copyPropertiesAndChildrenFrom(temp, nullptr);
+        }
+    }
+    else
+    {
+        stateToAppendTo.state.appendChild(temp, nullptr);
+    }
+}
+
+bool Load(const juce::ValueTree& curveAdjusterTree, std::vector<ConnectorPoints>& loadedPoints, size_t maxConnectors)
+{
+    auto setOfConnectorsChild = curveAdjusterTree.getChildWithName(connectors_ID);
+    //an empty curve would output 0 everywhere, so a damaged state leaves the current curve alone
+    if (!setOfConnectorsChild.isValid() || setOfConnectorsChild.getNumChildren() == 0)
+    {
+        return false;
+    }
+    //cutting the curve short would lose its end at x = 1
+    if (static_cast<size_t>(setOfConnectorsChild.getNumChildren()) > maxConnectors)
+    {
+        jassertfalse; //saved with a bigger capacity than this curve has!
+        return false;
+    }
+
+    loadedPoints.clear();
+    loadedPoints.reserve(static_cast<size_t>(setOfConnectorsChild.getNumChildren()));
+    for (auto i = 0; i < setOfConnectorsChild.getNumChildren(); ++i)
+    {
+        auto connectorChild = setOfConnectorsChild.getChild(i);
+        ConnectorPoints c;
+        c.start.x = (float)connectorChild.getChildWithName("startX").getProperty(value_string_as_ID, -2.0);
+        c.start.y = (float)connectorChild.getChildWithName("startY").getProperty(value_string_as_ID, -1.0);
+        c.control.x = (float)connectorChild.getChildWithName("controlX").getProperty(value_string_as_ID, -1.0);
+        c.control.y = (float)connectorChild.getChildWithName("controlY").getProperty(value_string_as_ID, -1.0);
+        c.end.x = (float)connectorChild.getChildWithName("endX").getProperty(value_string_as_ID, -1.0);
+        c.end.y = (float)connectorChild.getChildWithName("endY").getProperty(value_string_as_ID, -1.0);
+        //states saved before segment types were added have no type, which loads as automatic
+        const auto type = (int)connectorChild.getChildWithName("type").getProperty(value_string_as_ID, static_cast<int>(SegmentType::automatic));
+        c.type = juce::isPositiveAndNotGreaterThan(type, static_cast<int>(SegmentType::monotoneCubic)) ? static_cast<SegmentType>(type) : SegmentType::automatic;
+        loadedPoints.push_back(c);
+    }
+    return true;
+}
+
+}
+}
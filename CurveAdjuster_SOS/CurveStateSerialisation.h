@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    CurveStateSerialisation.h
+    Created: 17 Oct 2026 12:49:33pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "CurveAdjusterProcessorData.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+
+namespace CurveAdjuster
+{
+    /*the ValueTree layout a curve is saved in, shared by everything implementing ICurveAdjusterProcessor:
+        <name>
+          <control_coordinates>
+            <connector0> <startX value=".."/> ... <endY value=".."/> </connector0>
+            ...
+     */
+    namespace CurveStateSerialisation
+    {
+        //the curve as a tree named name, e.g. to nest several curves under one parent
+        juce::ValueTree CreateTree(const juce::Identifier& name, const std::vector<ConnectorPoints>& connectorPoints);
+        
+        //adds the curve under stateToAppendTo.state, replacing what was saved under name before
+        void Save(juce::AudioProcessorValueTreeState& stateToAppendTo, const juce::Identifier& name, const std::vector<ConnectorPoints>& connectorPoints);
+        
+        //false when curveAdjusterTree has no connectors to load, or more than maxConnectors
+        bool Load(const juce::ValueTree& curveAdjusterTree, std::vector<ConnectorPoints>& loadedPoints, size_t maxConnectors);
+    }
+}
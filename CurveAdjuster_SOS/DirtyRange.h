@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    DirtyRange.h
+    Created: 17 Oct 2026 1:04:31pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace CurveAdjuster
+{
+    /*the part of a curve an edit touched: the segments whose coefficients have to be rebuilt and the
+     inputs whose output may have changed (old and new positions of the edited connectors), so derived
+     tables only resample that stretch. ranges from several edits merge into one that covers them all*/
+    struct DirtyRange
+    {
+        size_t firstSegment {0};
+        size_t endSegment {0}; //one past the last
+        float startX {1.0f};
+        float endX {0.0f};
+
+        //everything, whatever the number of segments
+        static constexpr DirtyRange All()
+        {
+            return {0, std::numeric_limits<size_t>::max(), 0.0f, 1.0f};
+        }
+
+        constexpr bool IsEmpty() const
+        {
+            return firstSegment >= endSegment;
+        }
+
+        constexpr void Add(const DirtyRange& other)
+        {
+            if (other.IsEmpty())
+            {
+                return;
+            }
+            if (IsEmpty())
+            {
+                *this = other;
+                return;
+            }
+            firstSegment = std::min(firstSegment, other.firstSegment);
+            endSegment = std::max(endSegment, other.endSegment);
+            startX = std::min(startX, other.startX);
+            endX = std::max(endX, other.endX);
+        }
+
+        //widens the inputs to take in a connector's span
+        constexpr void AddInputs(float spanStartX, float spanEndX)
+        {
+            startX = std::min(startX, spanStartX);
+            endX = std::max(endX, spanEndX);
+        }
+    };
+}
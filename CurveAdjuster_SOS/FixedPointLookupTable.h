@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    FixedPointLookupTable.h
+    Created: 17 Oct 2026 12:44:26pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace CurveAdjuster
+{
+    /*CurveLookupTable at half the size: y (0 to 1) is stored as 16 bit fixed point and
+     interpolated with integers (16.15 position, so (upper - lower) * fraction fits in 32 bits).
+     rounding to 16 bits plus the integer interpolation add at most 1.5 / 65535 (about 2.3e-5)
+     to the interpolation error of the float table.
+     use CurveAdjusterProcessor::MeasureLookupTable to compare it with the float table for a curve*/
+    class FixedPointLookupTable
+    {
+    public:
+        static constexpr float fullScale {65535.0f};
+        static constexpr int fractionBits {15};
+
+        //allocates, so call from the message thread
+        void Resize(size_t numPoints)
+        {
+            numPoints = std::max(numPoints, static_cast<size_t>(2));
+            table.assign(numPoints, 0);
+            positionScale = static_cast<float>(numPoints - 1) * static_cast<float>(1 << fractionBits);
+            maxIndex = static_cast<uint32_t>(numPoints - 2);
+        }
+
+        //copies a table that was sampled elsewhere (e.g. read from disk), allocates
+        void Assign(const uint16_t* values, size_t numPoints)
+        {
+            Resize(numPoints);
+            std::copy(values, values + table.size(), table.begin());
+        }
+
+        void Clear()
+        {
+            table.clear();
+            table.shrink_to_fit();
+        }
+
+        template <typename Function>
+        void Fill(Function&& getY_AtX)
+        {
+            FillRange(0.0f, 1.0f, getY_AtX);
+        }
+
+        //same as CurveLookupTable::FillRange
+        template <typename Function>
+        void FillRange(float startX, float endX, Function&& getY_AtX)
+        {
+            if (table.empty())
+            {
+                return;
+            }
+            const auto scale = static_cast<float>(table.size() - 1);
+            const auto first = static_cast<size_t>(std::floor(std::clamp(startX, 0.0f, 1.0f) * scale));
+            const auto last = std::min(static_cast<size_t>(std::ceil(std::clamp(endX, 0.0f, 1.0f) * scale)), table.size() - 1);
+            for (size_t i = first; i <= last; ++i)
+            {
+                const auto y = std::clamp(getY_AtX(static_cast<float>(i) / scale), 0.0f, 1.0f);
+                table[i] = static_cast<uint16_t>(std::lround(y * fullScale));
+            }
+        }
+
+        float GetValue(float in_X) const
+        {
+            const auto position = static_cast<uint32_t>(std::clamp(in_X, 0.0f, 1.0f) * positionScale);
+            const auto index = std::min(position >> fractionBits, maxIndex);
+            const auto fraction = static_cast<int32_t>(position - (index << fractionBits));
+            const auto lower = static_cast<int32_t>(table[index]);
+            const auto upper = static_cast<int32_t>(table[index + 1]);
+            return static_cast<float>(lower + (((upper - lower) * fraction) >> fractionBits)) * (1.0f / fullScale);
+        }
+
+        void Process(const float* in, float* out, int numSamples) const
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                out[i] = GetValue(in[i]);
+            }
+        }
+
+        const uint16_t* GetData() const
+        {
+            return table.data();
+        }
+
+        size_t GetNumPoints() const
+        {
+            return table.size();
+        }
+
+        size_t GetSizeInBytes() const
+        {
+            return table.size() * sizeof(uint16_t);
+        }
+
+        bool IsEmpty() const
+        {
+            return table.empty();
+        }
+
+    private:
+        std::vector<uint16_t> table;
+        float positionScale {1.0f};
+        uint32_t maxIndex {0};
+    };
+}
@@ -23,6 +23,11 @@ namespace CurveAdjuster
         
 
         virtual size_t GetNumConnectors() = 0;
+        
+        /*goes up by one with every new curve and never goes down, so anything derived from the curve
+         (tables, thumbnails, saved blobs) only needs rebuilding when this differs from what it was built at.
+         any thread*/
+        virtual uint64_t GetGeneration() const = 0;
 
         virtual void SaveState(juce::AudioProcessorValueTreeState& stateToAppendTo) = 0;
         virtual void LoadAndRemoveStateFromAPTVS(juce::ValueTree& apvtsTree) = 0;
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    LinearSmoother.h
+    Created: 17 Oct 2026 12:53:37pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace CurveAdjuster
+{
+    /*linear ramp with the same behaviour as juce::SmoothedValue<float, Linear>,
+     kept here so a whole block of the ramp can be written in one pass. JUCE free, see CurveKernel.h*/
+    class LinearSmoother
+    {
+    public:
+        LinearSmoother(float initVal, double _rampLength)
+        : value(initVal), ramplength(_rampLength), target(initVal)
+        {
+        }
+
+        void Reset(double sampleRate)
+        {
+            stepsToTarget = static_cast<int>(std::floor(ramplength * sampleRate));
+            value = target;
+            countdown = 0;
+        }
+        float GetNextValue(float possibleNewTarget)
+        {
+            SetTarget(possibleNewTarget);
+            if (countdown > 0)
+            {
+                --countdown;
+                value = countdown > 0 ? value + step : target;
+            }
+            return value;
+        }
+
+        /*writes the next numSamples values to dest, checking for a new target once per block.
+         returns true when no ramp was running: every value in dest is then just value,
+         so callers can map it once instead of per sample*/
+        bool GetNextBlock(float possibleNewTarget, float* dest, int numSamples)
+        {
+            SetTarget(possibleNewTarget);
+            if (numSamples <= 0)
+            {
+                return ! IsSmoothing();
+            }
+            if (countdown <= 0)
+            {
+                std::fill(dest, dest + numSamples, value);
+                return true;
+            }
+
+            const auto rampSamples = std::min(countdown, numSamples);
+            const auto start = value;
+            for (int i = 0; i < rampSamples; ++i)
+            {
+                dest[i] = start + step * static_cast<float>(i + 1);
+            }
+            countdown -= rampSamples;
+            if (countdown == 0)
+            {
+                //land exactly on the target, then hold it
+                dest[rampSamples - 1] = target;
+                std::fill(dest + rampSamples, dest + numSamples, target);
+            }
+            value = dest[rampSamples - 1];
+            return false;
+        }
+
+        bool IsSmoothing() const
+        {
+            return countdown > 0;
+        }
+
+        //same tolerance as juce::approximatelyEqual, so targets jittering in the last bit don't restart the ramp
+        static bool IsSameTarget(float a, float b)
+        {
+            const auto difference = std::abs(a - b);
+            return difference < std::numeric_limits<float>::min()
+                || difference <= std::numeric_limits<float>::epsilon() * std::max(std::abs(a), std::abs(b));
+        }
+
+        float value;
+        const double ramplength;
+    private:
+
+        void SetTarget(float possibleNewTarget)
+        {
+            if (IsSameTarget(possibleNewTarget, target))
+            {
+                return;
+            }
+            target = possibleNewTarget;
+            if (stepsToTarget <= 0)
+            {
+                value = target;
+                countdown = 0;
+                return;
+            }
+            countdown = stepsToTarget;
+            step = (target - value) / static_cast<float>(countdown);
+        }
+
+        float target;
+        float step {0.0f};
+        int countdown {0};
+        int stepsToTarget {0};
+    };
+}
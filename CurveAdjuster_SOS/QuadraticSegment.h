@@ -0,0 +1,326 @@
+/*
+  ==============================================================================
+
+    QuadraticSegment.h
+    Created: 17 Oct 2026 12:34:40pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace CurveAdjuster
+{
+    //what a connector is evaluated as. automatic lets FromPoints pick linear or hold for straight quadratics
+    enum class SegmentType : int32_t
+    {
+        automatic,
+        linear,
+        hold,          //startY all the way across, a step to the next segment
+        quadratic,
+        monotoneCubic  //smooth through its end points without overshooting, see SegmentBuilder
+    };
+
+    /*power basis coefficients of one quadratic bezier connector:
+        x(t) = (ax * t + bx) * t + startX
+        y(t) = ((cy * t + ay) * t + by) * t + startY     (cy is 0 unless monotoneCubic)
+
+     linear, hold and monotoneCubic segments have x linear in t (ax = 0), so t comes straight from
+     invWidth instead of the square root below. the block kernels rely on that layout for every type.
+
+     the editor limits control.x to [start.x, end.x], so x(t) never decreases on [0, 1]
+     and x(t) = in_X has exactly one root there, which is solved for directly.
+
+     error: float rounding of in_X and the coefficients, scaled by the slope where in_X lands.
+     measured, not proven: against an exact (long double bisection) solve over millions of random
+     segments and inputs, |y - exact bezier y| stayed under 2e-7 * (1 + |dy/dx at in_X|).
+     the chord slope is no substitute, near a vertical tangent (control.x == start.x) the local
+     slope is far steeper, and it's unbounded right at the tangent.
+     the previous evaluator flattened a juce::Path with the default tolerance, which
+     in these 0-1 coordinates is a coarse polyline, so results can differ from it by up
+     to that flattening error (the new value is the one the editor draws)
+     */
+    struct QuadraticSegment
+    {
+        /*a quadratic, or the cheaper linear or hold when the control point is (within straightTolerance)
+         on the line between the end points, which is also what the editor's default connector is*/
+        static constexpr QuadraticSegment FromPoints(float startX, float startY, float controlX, float controlY, float endX, float endY)
+        {
+            const auto width = endX - startX;
+            const auto rise = endY - startY;
+            //the curve strays from the chord by at most half the control point's distance from it
+            const auto cross = (controlX - startX) * rise - (controlY - startY) * width;
+            const auto isStraight = width > 0.0f && cross * cross <= 4.0f * straightTolerance * straightTolerance * (width * width + rise * rise);
+            if (isStraight)
+            {
+                return rise == 0.0f ? Hold(startX, startY, endX) : Linear(startX, startY, endX, endY);
+            }
+            return Quadratic(startX, startY, controlX, controlY, endX, endY);
+        }
+
+        //always a quadratic, even when straight
+        static constexpr QuadraticSegment Quadratic(float startX, float startY, float controlX, float controlY, float endX, float endY)
+        {
+            QuadraticSegment s;
+            s.type = SegmentType::quadratic;
+            s.startX = startX;
+            s.startY = startY;
+            s.endX = endX;
+            s.endY = endY;
+            s.ax = startX - 2.0f * controlX + endX;
+            s.bx = 2.0f * (controlX - startX);
+            s.bxFromEnd = 2.0f * (endX - controlX);
+            s.ay = startY - 2.0f * controlY + endY;
+            s.by = 2.0f * (controlY - startY);
+            return s;
+        }
+
+        static constexpr QuadraticSegment Linear(float startX, float startY, float endX, float endY)
+        {
+            auto s = LinearInX(SegmentType::linear, startX, startY, endX, endY);
+            s.by = endY - startY;
+            return s;
+        }
+
+        static constexpr QuadraticSegment Hold(float startX, float startY, float endX)
+        {
+            return LinearInX(SegmentType::hold, startX, startY, endX, startY);
+        }
+
+        /*cubic hermite through the end points with the given dy/dx at each. the slopes are limited to
+         0 to 3 times the chord's slope, which keeps the segment from overshooting its end points*/
+        static constexpr QuadraticSegment MonotoneCubic(float startX, float startY, float endX, float endY, float startSlope, float endSlope)
+        {
+            auto s = LinearInX(SegmentType::monotoneCubic, startX, startY, endX, endY);
+            const auto width = endX - startX;
+            const auto rise = endY - startY;
+            const auto chordSlope = width > 0.0f ? rise / width : 0.0f;
+            auto limit = [chordSlope](float slope)
+            {
+                if (chordSlope == 0.0f || slope * chordSlope <= 0.0f)
+                {
+                    return 0.0f;
+                }
+                return chordSlope > 0.0f ? std::min(slope, 3.0f * chordSlope) : std::max(slope, 3.0f * chordSlope);
+            };
+            const auto startRise = limit(startSlope) * width;
+            const auto endRise = limit(endSlope) * width;
+            s.by = startRise;
+            s.ay = 3.0f * rise - 2.0f * startRise - endRise;
+            s.cy = startRise + endRise - 2.0f * rise;
+            return s;
+        }
+
+        /*solves a*u^2 + b*u = d using the form without cancellation:
+        u = 2d / (b + sqrt(b^2 + 4*a*d)), which stays valid when a == 0 (straight line)
+        and when b == 0 (control point on top of an end point).
+        u is measured from whichever end point is nearer to in_X. near an end where the
+        tangent is vertical, solving from the far end loses most of the float precision*/
+        float GetT_AtX(float in_X) const
+        {
+            return GetT_AtX(in_X, [](float v) { return std::sqrt(v); });
+        }
+
+        //same, with the square root supplied, so BakedCurve can solve at compile time
+        template <typename SquareRoot>
+        constexpr float GetT_AtX(float in_X, SquareRoot&& squareRoot) const
+        {
+            if (IsLinearInX())
+            {
+                return std::clamp((in_X - startX) * invWidth, 0.0f, 1.0f);
+            }
+            const bool fromStart = in_X - startX <= endX - in_X;
+            const float d = fromStart ? in_X - startX : endX - in_X;
+            const float a = fromStart ? ax : -ax;
+            const float b = fromStart ? bx : bxFromEnd;
+            const float discriminant = std::max(b * b + 4.0f * a * d, 0.0f);
+            const float u = std::clamp(2.0f * d / std::max(b + squareRoot(discriminant), minDenominator), 0.0f, 1.0f);
+            return fromStart ? u : 1.0f - u;
+        }
+
+        /*the t in [0, 1] where y(t) = in_Y, smallest first (and so smallest x first).
+         returns how many were written to roots: 0, 1 or 2. a flat segment at in_Y gives t = 0*/
+        int GetT_AtY(float in_Y, float (&roots)[2]) const
+        {
+            constexpr float tolerance {1.0e-6f};
+            const float d = in_Y - startY;
+            int numRoots = 0;
+            auto addRoot = [&](float t)
+            {
+                if (t >= -tolerance && t <= 1.0f + tolerance)
+                {
+                    roots[numRoots++] = std::clamp(t, 0.0f, 1.0f);
+                }
+            };
+            
+            if (type == SegmentType::monotoneCubic)
+            {
+                //monotone, so at most one root (or a flat run, which gives its start), found by bisection
+                const auto low = std::min(startY, endY);
+                const auto high = std::max(startY, endY);
+                if (in_Y < low - tolerance || in_Y > high + tolerance)
+                {
+                    return numRoots;
+                }
+                const auto rising = endY >= startY;
+                auto lowerT = 0.0f;
+                auto upperT = 1.0f;
+                for (int i = 0; i < 32; ++i)
+                {
+                    const auto midT = 0.5f * (lowerT + upperT);
+                    if ((GetY_AtT(midT) < in_Y) == rising)
+                    {
+                        lowerT = midT;
+                    }
+                    else
+                    {
+                        upperT = midT;
+                    }
+                }
+                addRoot(rising ? upperT : lowerT);
+                return numRoots;
+            }
+            
+            if (std::abs(ay) <= minDenominator)
+            {
+                if (std::abs(by) <= minDenominator)
+                {
+                    if (std::abs(d) <= tolerance)
+                    {
+                        addRoot(0.0f);
+                    }
+                    return numRoots;
+                }
+                addRoot(d / by);
+                return numRoots;
+            }
+            
+            //ay*t^2 + by*t - d = 0, the two roots without cancellation
+            const float discriminant = by * by + 4.0f * ay * d;
+            if (discriminant < 0.0f)
+            {
+                //the extremum only just misses in_Y, count a touch within rounding as a root
+                const float extremumT = -by / (2.0f * ay);
+                if (std::abs(GetY_AtT(std::clamp(extremumT, 0.0f, 1.0f)) - in_Y) <= tolerance)
+                {
+                    addRoot(extremumT);
+                }
+                return numRoots;
+            }
+            const float q = -0.5f * (by + std::copysign(std::sqrt(discriminant), by));
+            const float first = q / ay;
+            const float second = std::abs(q) > minDenominator ? -d / q : first;
+            addRoot(std::min(first, second));
+            if (second != first)
+            {
+                addRoot(std::max(first, second));
+            }
+            return numRoots;
+        }
+
+        constexpr float GetX_AtT(float t) const
+        {
+            return (ax * t + bx) * t + startX;
+        }
+
+        constexpr float GetY_AtT(float t) const
+        {
+            return ((cy * t + ay) * t + by) * t + startY;
+        }
+
+        //dispatches on type, only quadratics need the square root
+        float GetY_AtX(float in_X) const
+        {
+            switch (type)
+            {
+                case SegmentType::hold:
+                    return startY;
+                case SegmentType::linear:
+                    return by * std::clamp((in_X - startX) * invWidth, 0.0f, 1.0f) + startY;
+                default:
+                    return GetY_AtT(GetT_AtX(in_X));
+            }
+        }
+
+        constexpr bool IsLinearInX() const
+        {
+            return type != SegmentType::quadratic && invWidth > 0.0f;
+        }
+
+        /*area under the segment from startX to x(t): the integral of y(t) * x'(t) dt, a polynomial in t
+         (degree 4, or 5 with cy and ax, which no segment type has together).
+         double, because antialiasing divides differences of it by tiny input steps*/
+        double GetArea_AtT(double t) const
+        {
+            const double y0 = startY, dax = ax, dbx = bx, day = ay, dby = by, dcy = cy;
+            const double c1 = y0 * dbx;
+            const double c2 = 0.5 * (dby * dbx + 2.0 * dax * y0);
+            const double c3 = (day * dbx + 2.0 * dax * dby) / 3.0;
+            const double c4 = 0.25 * (dcy * dbx + 2.0 * dax * day);
+            const double c5 = 0.4 * dax * dcy;
+            return ((((c5 * t + c4) * t + c3) * t + c2) * t + c1) * t;
+        }
+
+        /*dy/dx = (dy/dt) / (dx/dt). dx/dt never goes below 0 on [0, 1], where it reaches 0
+         (vertical tangent) the slope is huge but finite*/
+        constexpr float GetSlope_AtT(float t) const
+        {
+            return ((3.0f * cy * t + 2.0f * ay) * t + by) / std::max(2.0f * ax * t + bx, minDenominator);
+        }
+
+        /*steepest |dy/dx| anywhere on the segment. for a quadratic the slope is a ratio of two linear
+         functions of t with no pole inside (0, 1), so its extremes are at the end points.
+         a cubic's slope is a parabola in t, so its vertex is checked too*/
+        float GetMaxAbsSlope() const
+        {
+            auto maxSlope = std::max(std::abs(GetSlope_AtT(0.0f)), std::abs(GetSlope_AtT(1.0f)));
+            if (cy != 0.0f)
+            {
+                const auto vertexT = -ay / (3.0f * cy);
+                if (vertexT > 0.0f && vertexT < 1.0f)
+                {
+                    maxSlope = std::max(maxSlope, std::abs(GetSlope_AtT(vertexT)));
+                }
+            }
+            return maxSlope;
+        }
+
+        static constexpr float minDenominator {1.0e-12f};
+        //control points this close to the chord (in 0-1 units) count as straight
+        static constexpr float straightTolerance {1.0e-6f};
+
+        float startX {-1.0f};
+        float startY {-1.0f};
+        float endX {-1.0f};
+        float endY {-1.0f};
+        float ax {0.0f};
+        float bx {0.0f};
+        float bxFromEnd {0.0f};
+        float ay {0.0f};
+        float by {0.0f};
+        float cy {0.0f};
+        float invWidth {0.0f}; //1 / (endX - startX) when x is linear in t, else 0
+        SegmentType type {SegmentType::quadratic};
+
+    private:
+        static constexpr QuadraticSegment LinearInX(SegmentType type, float startX, float startY, float endX, float endY)
+        {
+            QuadraticSegment s;
+            s.type = type;
+            s.startX = startX;
+            s.startY = startY;
+            s.endX = endX;
+            s.endY = endY;
+            s.bx = endX - startX;
+            s.bxFromEnd = s.bx;
+            s.invWidth = s.bx > 0.0f ? 1.0f / s.bx : 0.0f;
+            return s;
+        }
+    };
+
+    static_assert(sizeof(QuadraticSegment) == 12 * sizeof(float), "the block kernels gather segments as arrays of floats");
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    SegmentBuilder.h
+    Created: 17 Oct 2026 12:59:44pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "QuadraticSegment.h"
+#include <cstddef>
+
+namespace CurveAdjuster
+{
+    //one connector in 0-1 coordinates, the layout CurveAdjusterProcessor::ExportAsCppHeader writes
+    struct ConnectorDefinition
+    {
+        float startX, startY, controlX, controlY, endX, endY;
+        SegmentType type {SegmentType::automatic}; //the control point is ignored by linear, hold and monotoneCubic
+    };
+
+    namespace SegmentBuilder
+    {
+        constexpr float GetChordSlope(const ConnectorDefinition& c)
+        {
+            const auto width = c.endX - c.startX;
+            return width > 0.0f ? (c.endY - c.startY) / width : 0.0f;
+        }
+
+        //every type but monotoneCubic is built from its own connector alone
+        constexpr QuadraticSegment BuildStandalone(const ConnectorDefinition& c)
+        {
+            switch (c.type)
+            {
+                case SegmentType::linear:
+                    return QuadraticSegment::Linear(c.startX, c.startY, c.endX, c.endY);
+                case SegmentType::hold:
+                    return QuadraticSegment::Hold(c.startX, c.startY, c.endX);
+                case SegmentType::quadratic:
+                    return QuadraticSegment::Quadratic(c.startX, c.startY, c.controlX, c.controlY, c.endX, c.endY);
+                case SegmentType::automatic:
+                case SegmentType::monotoneCubic:
+                default:
+                    return QuadraticSegment::FromPoints(c.startX, c.startY, c.controlX, c.controlY, c.endX, c.endY);
+            }
+        }
+
+        /*slope a monotone cubic takes where it meets a neighbour: the neighbour's own slope there,
+         so the join is smooth, or between two cubics the harmonic mean of their chord slopes
+         (flat where the curve turns). MonotoneCubic then limits it so the cubic can't overshoot*/
+        constexpr float GetSlopeAtJoin(const ConnectorDefinition& c, const ConnectorDefinition& neighbour, float neighbourT)
+        {
+            if (neighbour.type != SegmentType::monotoneCubic)
+            {
+                return BuildStandalone(neighbour).GetSlope_AtT(neighbourT);
+            }
+            const auto chordSlope = GetChordSlope(c);
+            const auto neighbourSlope = GetChordSlope(neighbour);
+            if (neighbourSlope * chordSlope <= 0.0f)
+            {
+                return 0.0f;
+            }
+            return 2.0f * neighbourSlope * chordSlope / (neighbourSlope + chordSlope);
+        }
+
+        //segment for connector index, where getConnector(i) returns connector i as a ConnectorDefinition
+        template <typename GetConnector>
+        constexpr QuadraticSegment BuildSegment(GetConnector&& getConnector, size_t index, size_t numConnectors)
+        {
+            const ConnectorDefinition c = getConnector(index);
+            if (c.type != SegmentType::monotoneCubic)
+            {
+                return BuildStandalone(c);
+            }
+            //the chord slope at either end of the curve
+            const auto chordSlope = GetChordSlope(c);
+            const auto startSlope = index > 0 ? GetSlopeAtJoin(c, getConnector(index - 1), 1.0f) : chordSlope;
+            const auto endSlope = index + 1 < numConnectors ? GetSlopeAtJoin(c, getConnector(index + 1), 0.0f) : chordSlope;
+            return QuadraticSegment::MonotoneCubic(c.startX, c.startY, c.endX, c.endY, startSlope, endSlope);
+        }
+
+        template <typename GetConnector>
+        constexpr void BuildSegments(GetConnector&& getConnector, size_t numConnectors, QuadraticSegment* segments)
+        {
+            for (size_t i = 0; i < numConnectors; ++i)
+            {
+                segments[i] = BuildSegment(getConnector, i, numConnectors);
+            }
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    SegmentCursor.h
+    Created: 17 Oct 2026 12:38:47pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "QuadraticSegment.h"
+#include <algorithm>
+
+namespace CurveAdjuster
+{
+    /*finds the segment an x lies in: the last one whose startX is <= x (same rule as BlockKernels).
+     remembers the previous answer, so smoothly moving inputs that stay in the same or a
+     neighbouring segment cost O(1). anything further away falls back to a binary search, O(log n).
+     keep one cursor per thread, it is not shared safely*/
+    class SegmentCursor
+    {
+    public:
+        size_t Find(const QuadraticSegment* segments, size_t numSegments, float x)
+        {
+            if (numSegments == 0)
+            {
+                return 0;
+            }
+            if (index >= numSegments)
+            {
+                index = 0;
+            }
+
+            if (Contains(segments, numSegments, index, x))
+            {
+                return index;
+            }
+            if (index + 1 < numSegments && Contains(segments, numSegments, index + 1, x))
+            {
+                return ++index;
+            }
+            if (index > 0 && Contains(segments, numSegments, index - 1, x))
+            {
+                return --index;
+            }
+
+            //segments[0] always starts at 0 so only the rest need searching
+            auto* firstAfterX = std::upper_bound(segments + 1, segments + numSegments, x,
+                                                 [](float value, const QuadraticSegment& s) { return value < s.startX; });
+            index = static_cast<size_t>(firstAfterX - segments) - 1;
+            return index;
+        }
+
+    private:
+        size_t index {0};
+
+        static bool Contains(const QuadraticSegment* segments, size_t numSegments, size_t i, float x)
+        {
+            return segments[i].startX <= x && (i + 1 == numSegments || x < segments[i + 1].startX);
+        }
+    };
+}
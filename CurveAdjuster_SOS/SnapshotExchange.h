@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    SnapshotExchange.h
+    Created: 17 Oct 2026 12:42:12pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace CurveAdjuster
+{
+    /*hands whole objects from one writer thread to one reader thread without locks or allocation.
+     the writer fills GetWriteBuffer() and Publish()es it with a single atomic exchange.
+     the reader calls Update() and keeps using Get() until its next Update(), so it never sees
+     a half written object. the reader holds on to its numHeld newest objects (Get(1) is the one
+     before the newest, e.g. to crossfade from), and the writer never touches any of them.
+     with numHeld = 1 this is a plain triple buffer.
+     the reader can hold fewer than numHeld for a while with SetNumInUse. the objects it lets go of are
+     parked, and the writer can empty them with ReclaimParked so they don't keep their memory*/
+    template <typename T, size_t numHeld = 1>
+    class SnapshotExchange
+    {
+    public:
+        static_assert(numHeld >= 1, "the reader has to hold at least the newest object");
+        static constexpr size_t numBuffers {numHeld + 2};
+
+        explicit SnapshotExchange(const T& initial)
+        : buffers(CopyInto(initial, std::make_index_sequence<numBuffers>()))
+        {
+            for (size_t i = 0; i < numHeld; ++i)
+            {
+                held[i] = static_cast<int>(i) + 2;
+            }
+            for (auto& state : states)
+            {
+                state.store(inUse, std::memory_order_relaxed);
+            }
+        }
+
+        //writer side
+        T& GetWriteBuffer()
+        {
+            return buffers[static_cast<size_t>(writeIndex)];
+        }
+
+        /*which of the numBuffers objects GetWriteBuffer() is. buffers come back to the writer holding
+         whatever was last written into them, so a writer can track per index what each one is missing*/
+        size_t GetWriteIndex() const
+        {
+            return static_cast<size_t>(writeIndex);
+        }
+
+        void Publish()
+        {
+            const auto previous = shared.exchange(writeIndex | newDataFlag, std::memory_order_acq_rel);
+            writeIndex = previous & indexMask;
+        }
+
+        /*calls reclaim(object, index) for each object the reader has parked and not taken back since,
+         e.g. to free what it holds. the object is brought back to life as it was left, so the writer should
+         treat it as out of date. never touches the write buffer or what the reader is holding*/
+        template <typename Function>
+        void ReclaimParked(Function&& reclaim)
+        {
+            for (size_t i = 0; i < numBuffers; ++i)
+            {
+                auto expected = parked;
+                if (states[i].compare_exchange_strong(expected, reclaiming, std::memory_order_acquire))
+                {
+                    reclaim(buffers[i], i);
+                    states[i].store(reclaimed, std::memory_order_release);
+                }
+            }
+        }
+
+        //reader side, returns true when a newer object was taken
+        bool Update()
+        {
+            if ((shared.load(std::memory_order_relaxed) & newDataFlag) == 0)
+            {
+                return false;
+            }
+            //the oldest held object goes back to the writer
+            const auto newest = shared.exchange(held[numInUse - 1], std::memory_order_acq_rel) & indexMask;
+            for (size_t i = numInUse - 1; i > 0; --i)
+            {
+                held[i] = held[i - 1];
+            }
+            held[0] = newest;
+            return true;
+        }
+
+        /*reader side, how many of the newest objects to hold from now on (1 to numHeld). fewer parks the oldest,
+         more takes parked ones back once the writer has reclaimed them, so it can take a few calls.
+         an object taken back is older than anything held, Get() it only after the next Update()*/
+        void SetNumInUse(size_t n)
+        {
+            n = std::clamp<size_t>(n, 1, numHeld);
+            while (numInUse > n)
+            {
+                --numInUse;
+                states[static_cast<size_t>(held[numInUse])].store(parked, std::memory_order_release);
+            }
+            for (size_t i = 0; i < numBuffers && numInUse < n; ++i)
+            {
+                auto expected = reclaimed;
+                if (states[i].compare_exchange_strong(expected, inUse, std::memory_order_acquire))
+                {
+                    held[numInUse++] = static_cast<int>(i);
+                }
+            }
+        }
+
+        size_t GetNumInUse() const
+        {
+            return numInUse;
+        }
+
+        //0 is the newest, GetNumInUse() - 1 the oldest
+        const T& Get(size_t age = 0) const
+        {
+            return buffers[static_cast<size_t>(held[age])];
+        }
+
+        const T& Acquire()
+        {
+            Update();
+            return Get();
+        }
+
+    private:
+        template <size_t... indices>
+        static std::array<T, sizeof...(indices)> CopyInto(const T& initial, std::index_sequence<indices...>)
+        {
+            return {{ ((void) indices, initial)... }};
+        }
+
+        static constexpr int indexMask {0xff};
+        static constexpr int newDataFlag {0x100};
+        
+        //per object, only ever moved on by the side named: inUse -> parked (reader) -> reclaiming -> reclaimed (writer) -> inUse (reader)
+        static constexpr int inUse {0};
+        static constexpr int parked {1};
+        static constexpr int reclaiming {2};
+        static constexpr int reclaimed {3};
+
+        std::array<T, numBuffers> buffers;
+        int writeIndex {0};
+        std::atomic<int> shared {1};
+        std::array<int, numHeld> held;
+        size_t numInUse {numHeld}; //reader only
+        std::array<std::atomic<int>, numBuffers> states;
+    };
+}
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    VoiceSmoothers.h
+    Created: 17 Oct 2026 12:40:09pm
+    Author:  agent
+
+  ==============================================================================
+*/
+
+#pragma once
+#include "LinearSmoother.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace CurveAdjuster
+{
+    /*one linear smoother per voice (same ramp as SmoothedValueManager), stored as contiguous arrays
+     so Advance() steps every voice at once in a loop the compiler vectorizes across voices.
+     everything here is allocation free after construction, so it can live on the audio thread*/
+    class VoiceSmoothers
+    {
+    public:
+        VoiceSmoothers(int maxVoices, float initVal, double _rampLength)
+        : rampLength(_rampLength),
+          current(static_cast<size_t>(maxVoices), initVal),
+          target(static_cast<size_t>(maxVoices), initVal),
+          step(static_cast<size_t>(maxVoices), 0.0f),
+          countdown(static_cast<size_t>(maxVoices), 0),
+          curveOutput(static_cast<size_t>(maxVoices), 0.0f),
+          crossfadeOutput(static_cast<size_t>(maxVoices), 0.0f),
+          activeInput(static_cast<size_t>(maxVoices), 0.0f),
+          activeVoices(static_cast<size_t>(maxVoices), 0)
+        {
+        }
+
+        //jumps every voice to its target
+        void Reset(double sampleRate)
+        {
+            stepsToTarget = static_cast<int>(std::floor(rampLength * sampleRate));
+            std::copy(target.begin(), target.end(), current.begin());
+            std::fill(countdown.begin(), countdown.end(), 0);
+        }
+
+        //starts a ramp when the target changed, like SmoothedValueManager::GetNextValue
+        void SetTarget(int voice, float newTarget)
+        {
+            const auto v = static_cast<size_t>(voice);
+            if (LinearSmoother::IsSameTarget(newTarget, target[v]))
+            {
+                return;
+            }
+            target[v] = newTarget;
+            if (stepsToTarget <= 0)
+            {
+                current[v] = newTarget;
+                countdown[v] = 0;
+                return;
+            }
+            countdown[v] = stepsToTarget;
+            step[v] = (newTarget - current[v]) / static_cast<float>(stepsToTarget);
+        }
+
+        //jumps one voice straight to a value, e.g. on note on
+        void SetCurrentAndTarget(int voice, float value)
+        {
+            const auto v = static_cast<size_t>(voice);
+            current[v] = value;
+            target[v] = value;
+            countdown[v] = 0;
+        }
+
+        //moves every voice one sample along its ramp
+        void Advance()
+        {
+            const auto numVoices = current.size();
+            for (size_t v = 0; v < numVoices; ++v)
+            {
+                countdown[v] -= countdown[v] > 0 ? 1 : 0;
+                current[v] = countdown[v] > 0 ? current[v] + step[v] : target[v];
+            }
+        }
+
+        bool IsSmoothing(int voice) const
+        {
+            return countdown[static_cast<size_t>(voice)] > 0;
+        }
+
+        int GetMaxVoices() const
+        {
+            return static_cast<int>(current.size());
+        }
+
+        const float* GetCurrentValues() const
+        {
+            return current.data();
+        }
+
+        //lists the voices that have an output, once per block. returns how many there are
+        int GatherActiveVoices(const float* const* voiceOutputs)
+        {
+            numActive = 0;
+            for (int v = 0; v < GetMaxVoices(); ++v)
+            {
+                if (voiceOutputs[v] != nullptr)
+                {
+                    activeVoices[static_cast<size_t>(numActive++)] = v;
+                }
+            }
+            return numActive;
+        }
+
+        const int* GetActiveVoices() const
+        {
+            return activeVoices.data();
+        }
+
+        //the current values of the voices from GatherActiveVoices, packed together so only they get mapped
+        const float* GetActiveValues()
+        {
+            for (int i = 0; i < numActive; ++i)
+            {
+                activeInput[static_cast<size_t>(i)] = current[static_cast<size_t>(activeVoices[static_cast<size_t>(i)])];
+            }
+            return activeInput.data();
+        }
+
+        //scratch space the processor maps the active values into
+        float* GetCurveOutput()
+        {
+            return curveOutput.data();
+        }
+
+        float* GetCrossfadeOutput()
+        {
+            return crossfadeOutput.data();
+        }
+
+    private:
+        const double rampLength;
+        int stepsToTarget {0};
+
+        std::vector<float> current;
+        std::vector<float> target;
+        std::vector<float> step;
+        std::vector<int> countdown;
+        std::vector<float> curveOutput;
+        std::vector<float> crossfadeOutput;
+        std::vector<float> activeInput;
+        std::vector<int> activeVoices;
+        int numActive {0};
+    };
+}
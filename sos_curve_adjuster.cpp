@@ -1,9 +1,15 @@
 #include "sos_curve_adjuster.h"
 
+#include "CurveAdjuster_SOS/CompiledCurveCache.cpp"
 #include "CurveAdjuster_SOS/Connector.cpp"
+#include "CurveAdjuster_SOS/CurveAdjusterBank.cpp"
 #include "CurveAdjuster_SOS/CurveAdjusterComponent.cpp"
 #include "CurveAdjuster_SOS/CurveAdjusterEditor.cpp"
 #include "CurveAdjuster_SOS/CurveAdjusterProcessor.cpp"
+#include "CurveAdjuster_SOS/CurveCompiler.cpp"
+#include "CurveAdjuster_SOS/CurveComposition.cpp"
+#include "CurveAdjuster_SOS/CurveMorph.cpp"
+#include "CurveAdjuster_SOS/CurveStateSerialisation.cpp"
 #include "CurveAdjuster_SOS/MovableHandleBase.cpp"
 #include "CurveAdjuster_SOS/MultiSelectionManager.cpp"
 #include "CurveAdjuster_SOS/StationaryHandle.cpp"
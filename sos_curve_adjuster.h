@@ -10,28 +10,48 @@ BEGIN_JUCE_MODULE_DECLARATION
       name:             sos_curve_adjuster
       description:      CurveAdjusterSlidersSynthsOfSelf
       license:          GPL/Commercial
-      dependencies:     juce_audio_utils, juce_gui_basics, juce_graphics, juce_audio_processors, sos_sliders, sos_maths
+      dependencies:     juce_audio_utils, juce_gui_basics, juce_graphics, juce_audio_processors, juce_dsp, sos_sliders, sos_maths
 
      END_JUCE_MODULE_DECLARATION
 
 #endif
 
+#include "CurveAdjuster_SOS/AdaptiveLookupTable.h"
 #include "CurveAdjuster_SOS/AdjusterHandle1D.h"
 #include "CurveAdjuster_SOS/AdjusterHandle2D.h"
+#include "CurveAdjuster_SOS/BakedCurve.h"
+#include "CurveAdjuster_SOS/CompiledCurveCache.h"
 #include "CurveAdjuster_SOS/Connector.h"
+#include "CurveAdjuster_SOS/CurveAdjusterBank.h"
 #include "CurveAdjuster_SOS/CurveAdjusterComponent.h"
 #include "CurveAdjuster_SOS/CurveAdjusterEditor.h"
 #include "CurveAdjuster_SOS/CurveAdjusterPointTypes.h"
 #include "CurveAdjuster_SOS/CurveAdjusterProcessor.h"
 #include "CurveAdjuster_SOS/CurveAdjusterProcessorData.h"
+#include "CurveAdjuster_SOS/CurveBlockKernels.h"
+#include "CurveAdjuster_SOS/CurveKernel.h"
+#include "CurveAdjuster_SOS/CurveCompiler.h"
+#include "CurveAdjuster_SOS/CurveComposition.h"
+#include "CurveAdjuster_SOS/CurveLookupTable.h"
+#include "CurveAdjuster_SOS/CurveMorph.h"
+#include "CurveAdjuster_SOS/CurveSnapshot.h"
+#include "CurveAdjuster_SOS/CurveStateSerialisation.h"
 #include "CurveAdjuster_SOS/DebugHelperFunctions.h"
+#include "CurveAdjuster_SOS/DirtyRange.h"
+#include "CurveAdjuster_SOS/FixedPointLookupTable.h"
 #include "CurveAdjuster_SOS/IAdjusterHandle.h"
 #include "CurveAdjuster_SOS/ICurveAdjusterEditor.h"
 #include "CurveAdjuster_SOS/ICurveAdjusterProcessor.h"
+#include "CurveAdjuster_SOS/LinearSmoother.h"
 #include "CurveAdjuster_SOS/MouseIgnoringComponent.h"
 #include "CurveAdjuster_SOS/MovableHandleBase.h"
 #include "CurveAdjuster_SOS/MultiSelectionManager.h"
+#include "CurveAdjuster_SOS/QuadraticSegment.h"
+#include "CurveAdjuster_SOS/SegmentBuilder.h"
+#include "CurveAdjuster_SOS/SegmentCursor.h"
 #include "CurveAdjuster_SOS/SmoothedValueManager.h"
+#include "CurveAdjuster_SOS/SnapshotExchange.h"
 #include "CurveAdjuster_SOS/SOSUndoManager.h"
 #include "CurveAdjuster_SOS/StationaryHandle.h"
+#include "CurveAdjuster_SOS/VoiceSmoothers.h"
 